@@ -32,28 +32,24 @@ namespace Impact {
 
   Ball::Ball(Game *game, const TileParam &tileParam)
     : Body(Body::BodyType::Ball, game, tileParam)
+    , mVelocity(0.f, 0.f)
+    , mAngle(0.f)
   {
     mName = Name;
     setEnergy(1);
-    const sf::Texture &texture = mGame->level()->texture(mName);
-    sf::Image img;
-    img.create(texture.getSize().x + 2 * TextureMargin, texture.getSize().y + 2 * TextureMargin, sf::Color(0, 0, 0, 0));
-    img.copy(texture.copyToImage(), TextureMargin, TextureMargin, sf::IntRect(0, 0, 0, 0), true);
-    mTexture.loadFromImage(img);
-    setSmooth(mTileParam.smooth);
-
-    setHalfTextureSize(texture);
+    const sf::Vector2u &textureSize = mGame->level()->textureSize(mName);
+    if (!mGame->isHeadless()) {
+      const sf::Texture *texture = mGame->level()->paddedTexture(mGame->level()->bodyIndexByTextureName(mName));
+      if (texture != nullptr)
+        mSprite.setTexture(*texture, true);
+    }
 
-    const float32 halfW = .5f * mTexture.getSize().x;
-    const float32 halfH = .5f * mTexture.getSize().y;
+    setHalfTextureSize(textureSize);
 
-    mSprite.setTexture(mTexture);
-    mSprite.setOrigin(halfW, halfH);
+    mSprite.setOrigin(.5f * mSprite.getTextureRect().width, .5f * mSprite.getTextureRect().height);
 
     if (gLocalSettings().useShaders()) {
-      mShader.loadFromFile(ShadersDir + "/motionblur.vs", ShadersDir + "/motionblur.fs");
-      mShader.setParameter("uBlur", 2.f);
-      mShader.setParameter("uResolution", float(mTexture.getSize().x), float(mTexture.getSize().y));
+      mShader = ShaderRegistry::program(ShadersDir + "/motionblur.vs", ShadersDir + "/motionblur.fs");
     }
 
     b2BodyDef bd;
@@ -75,7 +71,7 @@ namespace Impact {
     case BodyShapeType::CircleShape:
     {
       b2CircleShape circle;
-      circle.m_radius = .5f * texture.getSize().x * Game::InvScale;
+      circle.m_radius = .5f * textureSize.x * Game::InvScale;
       fd.shape = &circle;
       mBody->CreateFixture(&fd);
       break;
@@ -83,7 +79,7 @@ namespace Impact {
     case BodyShapeType::PolygonShape:
     {
       b2PolygonShape square;
-      const float edge = .5f * Game::InvScale * texture.getSize().x;
+      const float edge = .5f * Game::InvScale * textureSize.x;
       square.SetAsBox(edge, edge);
       fd.shape = &square;
       mBody->CreateFixture(&fd);
@@ -99,21 +95,23 @@ namespace Impact {
   void Ball::onUpdate(float elapsedSeconds)
   {
     UNUSED(elapsedSeconds);
-    if (gLocalSettings().useShaders()) {
-      mShader.setParameter("uV", mBody->GetLinearVelocity().x, mBody->GetLinearVelocity().y);
-      mShader.setParameter("uRot", mBody->GetAngle());
-    }
-    else {
-      mSprite.setRotation(rad2deg(mBody->GetAngle()));
-    }
-    mSprite.setPosition(Game::Scale * mBody->GetPosition().x, Game::Scale * mBody->GetPosition().y);
+    mAngle = interpolatedAngle();
+    mVelocity = mBody->GetLinearVelocity();
+    if (!gLocalSettings().useShaders())
+      mSprite.setRotation(rad2deg(mAngle));
+    const b2Vec2 pos = interpolatedPosition();
+    mSprite.setPosition(Game::Scale * pos.x, Game::Scale * pos.y);
   }
 
 
   void Ball::onDraw(sf::RenderTarget &target, sf::RenderStates states) const
   {
-    if (gLocalSettings().useShaders()) {
-      states.shader = &mShader;
+    if (mShader != nullptr) {
+      mShader->setParameter("uBlur", 2.f);
+      mShader->setParameter("uResolution", float(mSprite.getTextureRect().width), float(mSprite.getTextureRect().height));
+      mShader->setParameter("uV", mVelocity.x, mVelocity.y);
+      mShader->setParameter("uRot", mAngle);
+      states.shader = mShader;
     }
     target.draw(mSprite, states);
   }
@@ -44,9 +44,11 @@ namespace Impact {
     static const float32 DefaultLinearDamping;
     static const float32 DefaultAngularDamping;
     static const std::string Name;
+    static const int TextureMargin = 24;
 
   private:
-    static const int TextureMargin = 24;
+    b2Vec2 mVelocity;
+    float32 mAngle;
 
   };
 
@@ -0,0 +1,200 @@
+/*
+
+    Copyright (c) 2015 Oliver Lau <ola@ct.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+
+#include "stdafx.h"
+
+#include <boost/filesystem.hpp>
+#include <boost/property_tree/ptree.hpp>
+#include <boost/property_tree/json_parser.hpp>
+
+#if defined(WIN32)
+#include <psapi.h>
+#pragma comment(lib, "psapi")
+#elif defined(LINUX_AMD64)
+#include <sys/resource.h>
+#endif
+
+namespace Impact {
+
+  const unsigned int Benchmark::DefaultTicks = 60 * 120; // one minute at 120 Hz
+  const uint32_t Benchmark::Seed = 0x494d5041U;
+  const double Benchmark::RegressionThreshold = .1; //MOD
+
+
+  static void addZipFiles(const boost::filesystem::path &dir, std::vector<std::string> &files)
+  {
+    boost::system::error_code ec;
+    if (!boost::filesystem::is_directory(dir, ec))
+      return;
+    std::vector<std::string> found;
+    boost::filesystem::recursive_directory_iterator it(dir, ec), end;
+    for (; it != end; it.increment(ec)) {
+      if (boost::filesystem::is_regular_file(it->path(), ec) && it->path().extension() == ".zip")
+        found.push_back(it->path().generic_string());
+    }
+    std::sort(found.begin(), found.end());
+    files.insert(files.end(), found.begin(), found.end());
+  }
+
+
+  std::vector<std::string> Benchmark::levelFiles(void)
+  {
+    std::vector<std::string> files;
+    addZipFiles(ResourcesDir + "/levels", files);
+    addZipFiles("testlevels", files);
+    return files;
+  }
+
+
+  uint64_t Benchmark::peakRSS(void)
+  {
+#if defined(WIN32)
+    PROCESS_MEMORY_COUNTERS pmc;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc)))
+      return uint64_t(pmc.PeakWorkingSetSize) / 1024U;
+    return 0U;
+#elif defined(LINUX_AMD64)
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return uint64_t(usage.ru_maxrss);
+#else
+    return 0U;
+#endif
+  }
+
+
+  void Benchmark::add(const BenchmarkResult &result)
+  {
+    mResults.push_back(result);
+  }
+
+
+  bool Benchmark::save(const std::string &filename) const
+  {
+    std::ofstream os(filename);
+    if (!os.is_open()) {
+      std::cerr << "Cannot open " << filename << " for writing" << std::endl;
+      return false;
+    }
+    os << std::fixed << std::setprecision(4);
+    os << "{" << std::endl << "  \"levels\": [" << std::endl;
+    for (std::vector<BenchmarkResult>::const_iterator r = mResults.cbegin(); r != mResults.cend(); ++r) {
+      os << "    {" << std::endl
+        << "      \"file\": \"" << r->zipFilename << "\"," << std::endl
+        << "      \"name\": \"" << r->name << "\"," << std::endl
+        << "      \"sha1\": \"" << r->sha1 << "\"," << std::endl
+        << "      \"ticks\": " << r->ticks << "," << std::endl
+        << "      \"loadMs\": " << r->loadMs << "," << std::endl
+        << "      \"buildMs\": " << r->buildMs << "," << std::endl
+        << "      \"meanStepMs\": " << r->meanStepMs << "," << std::endl
+        << "      \"p99StepMs\": " << r->p99StepMs << "," << std::endl
+        << "      \"peakBodies\": " << r->peakBodies << "," << std::endl
+        << "      \"peakContacts\": " << r->peakContacts << "," << std::endl
+        << "      \"peakRSSKB\": " << r->peakRSSKB << std::endl
+        << "    }" << (r + 1 != mResults.cend() ? "," : "") << std::endl;
+    }
+    os << "  ]" << std::endl << "}" << std::endl;
+    return os.good();
+  }
+
+
+  bool Benchmark::load(const std::string &filename)
+  {
+    mResults.clear();
+    boost::property_tree::ptree pt;
+    try {
+      boost::property_tree::json_parser::read_json(filename, pt);
+      const boost::property_tree::ptree &levels = pt.get_child("levels");
+      boost::property_tree::ptree::const_iterator li;
+      for (li = levels.begin(); li != levels.end(); ++li) {
+        const boost::property_tree::ptree &level = li->second;
+        BenchmarkResult r;
+        r.zipFilename = level.get<std::string>("file");
+        r.name = level.get<std::string>("name", std::string());
+        r.sha1 = level.get<std::string>("sha1", std::string());
+        r.ticks = level.get<unsigned int>("ticks", 0);
+        r.loadMs = level.get<double>("loadMs", 0.);
+        r.buildMs = level.get<double>("buildMs", 0.);
+        r.meanStepMs = level.get<double>("meanStepMs", 0.);
+        r.p99StepMs = level.get<double>("p99StepMs", 0.);
+        r.peakBodies = level.get<unsigned int>("peakBodies", 0);
+        r.peakContacts = level.get<unsigned int>("peakContacts", 0);
+        r.peakRSSKB = level.get<uint64_t>("peakRSSKB", 0);
+        mResults.push_back(r);
+      }
+    }
+    catch (const boost::property_tree::json_parser::json_parser_error &ex) {
+      std::cerr << "JSON parser error: " << ex.what() << " (line " << ex.line() << ")" << std::endl;
+      return false;
+    }
+    catch (const boost::property_tree::ptree_error &ex) {
+      std::cerr << filename << ": " << ex.what() << std::endl;
+      return false;
+    }
+    return true;
+  }
+
+
+  static std::string relativeChange(double baseline, double current)
+  {
+    if (baseline <= 0.)
+      return "n/a";
+    std::stringstream ss;
+    ss << std::fixed << std::setprecision(1) << std::showpos << 1e2 * (current - baseline) / baseline << "%";
+    return ss.str();
+  }
+
+
+  bool Benchmark::compare(const Benchmark &baseline, std::ostream &os) const
+  {
+    bool ok = true;
+    os << std::left << std::setw(40) << "level"
+      << std::right << std::setw(10) << "load" << std::setw(10) << "build"
+      << std::setw(10) << "step" << std::setw(10) << "p99"
+      << std::setw(10) << "bodies" << std::setw(10) << "contacts" << std::setw(10) << "rss" << std::endl;
+    for (std::vector<BenchmarkResult>::const_iterator r = mResults.cbegin(); r != mResults.cend(); ++r) {
+      std::vector<BenchmarkResult>::const_iterator b;
+      for (b = baseline.mResults.cbegin(); b != baseline.mResults.cend(); ++b)
+        if (b->zipFilename == r->zipFilename)
+          break;
+      os << std::left << std::setw(40) << r->zipFilename << std::right;
+      if (b == baseline.mResults.cend()) {
+        os << "  not in baseline" << std::endl;
+        continue;
+      }
+      if (b->sha1 != r->sha1 || b->ticks != r->ticks)
+        os << "  (level or tick count changed) ";
+      os << std::setw(10) << relativeChange(b->loadMs, r->loadMs)
+        << std::setw(10) << relativeChange(b->buildMs, r->buildMs)
+        << std::setw(10) << relativeChange(b->meanStepMs, r->meanStepMs)
+        << std::setw(10) << relativeChange(b->p99StepMs, r->p99StepMs)
+        << std::setw(10) << relativeChange(b->peakBodies, r->peakBodies)
+        << std::setw(10) << relativeChange(b->peakContacts, r->peakContacts)
+        << std::setw(10) << relativeChange(double(b->peakRSSKB), double(r->peakRSSKB));
+      if (b->meanStepMs > 0. && r->meanStepMs > (1. + RegressionThreshold) * b->meanStepMs) {
+        os << "  REGRESSION";
+        ok = false;
+      }
+      os << std::endl;
+    }
+    return ok;
+  }
+
+}
@@ -0,0 +1,77 @@
+/*
+
+    Copyright (c) 2015 Oliver Lau <ola@ct.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#ifndef __BENCHMARK_H_
+#define __BENCHMARK_H_
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <ostream>
+
+namespace Impact {
+
+  struct BenchmarkResult {
+    BenchmarkResult(void)
+      : ticks(0)
+      , loadMs(0.)
+      , buildMs(0.)
+      , meanStepMs(0.)
+      , p99StepMs(0.)
+      , peakBodies(0)
+      , peakContacts(0)
+      , peakRSSKB(0)
+    { /* ... */ }
+    std::string zipFilename;
+    std::string name;
+    std::string sha1;
+    unsigned int ticks;
+    double loadMs;
+    double buildMs;
+    double meanStepMs;
+    double p99StepMs;
+    unsigned int peakBodies;
+    unsigned int peakContacts;
+    uint64_t peakRSSKB;
+  };
+
+
+  class Benchmark {
+  public:
+    static const unsigned int DefaultTicks;
+    static const uint32_t Seed;
+    static const double RegressionThreshold;
+
+    static std::vector<std::string> levelFiles(void);
+    static uint64_t peakRSS(void);
+
+    void add(const BenchmarkResult &);
+    bool save(const std::string &filename) const;
+    bool load(const std::string &filename);
+    /// prints the relative change of every level against the baseline,
+    /// returns false if any step time got worse than RegressionThreshold
+    bool compare(const Benchmark &baseline, std::ostream &) const;
+
+  private:
+    std::vector<BenchmarkResult> mResults;
+  };
+
+}
+
+#endif // __BENCHMARK_H_
@@ -33,6 +33,8 @@ namespace Impact {
     : Body(Body::BodyType::Block, game, tileParam)
     , mGravityScale(2.f)
     , mMinimumHitImpulse(0)
+    , mFalling(false)
+    , mFallRequested(false)
   {
     mName = Name;
     mMinimumHitImpulse = mTileParam.minimumHitImpulse;
@@ -40,28 +42,23 @@ namespace Impact {
     setEnergy(mTileParam.minimumKillImpulse);
     setGravityScale(mTileParam.gravityScale);
 
-    const sf::Texture &texture = mGame->level()->tileParam(index).texture;
-    sf::Image img;
-    img.create(texture.getSize().x + 2 * TextureMargin, texture.getSize().y + 2 * TextureMargin, sf::Color(0, 0, 0, 0));
-    img.copy(texture.copyToImage(), TextureMargin, TextureMargin, sf::IntRect(0, 0, 0, 0), true);
-    mTexture.loadFromImage(img);
-    setSmooth(mTileParam.smooth);
+    const TileParam &tile = mGame->level()->tileParam(index);
+    if (!mGame->isHeadless() && !useAtlas(index, TextureAtlas::Margin)) {
+      const sf::Texture *texture = mGame->level()->paddedTexture(index);
+      if (texture != nullptr)
+        mSprite.setTexture(*texture, true);
+    }
+
+    setHalfTextureSize(tile.textureSize);
 
-    setHalfTextureSize(texture);
-    
-    mSprite.setTexture(mTexture);
-    mSprite.setOrigin(.5f * mTexture.getSize().x, .5f * mTexture.getSize().y);
+    mSprite.setOrigin(.5f * mSprite.getTextureRect().width, .5f * mSprite.getTextureRect().height);
 
     if (gLocalSettings().useShaders()) {
-      mShader.loadFromFile(ShadersDir + "/fallingblock.fs", sf::Shader::Fragment);
-      mShader.setParameter("uAge", 0.f);
-      mShader.setParameter("uBlur", 0.f);
-      mShader.setParameter("uColor", sf::Color(255U, 255U, 255U, 255U));
-      mShader.setParameter("uResolution", float(mTexture.getSize().x), float(mTexture.getSize().y));
+      mShader = ShaderRegistry::fragment(ShadersDir + "/fallingblock.fs");
     }
 
-    const unsigned int W = texture.getSize().x;
-    const unsigned int H = texture.getSize().y;
+    const unsigned int W = tile.textureSize.x;
+    const unsigned int H = tile.textureSize.y;
 
     b2BodyDef bd;
     bd.type = b2_dynamicBody;
@@ -123,17 +120,37 @@ namespace Impact {
   void Block::onUpdate(float elapsedSeconds)
   {
     UNUSED(elapsedSeconds);
-    mSprite.setPosition(Game::Scale * mBody->GetPosition().x, Game::Scale * mBody->GetPosition().y);
-    mSprite.setRotation(rad2deg(mBody->GetAngle()));
-    if (gLocalSettings().useShaders())
-      mShader.setParameter("uAge", age().asSeconds());
+    if (mFallRequested && !mFalling) {
+      mFalling = true;
+      if (mShader == nullptr)
+        mSprite.setColor(sf::Color(255U, 255U, 255U, 160U));
+    }
+    const b2Vec2 pos = interpolatedPosition();
+    mSprite.setPosition(Game::Scale * pos.x, Game::Scale * pos.y);
+    mSprite.setRotation(rad2deg(interpolatedAngle()));
+  }
+
+
+  bool Block::addTo(SpriteBatch &batch) const
+  {
+    // a falling block shakes, which only its shader can do
+    if (mFalling && mShader != nullptr)
+      return false;
+    return Body::addTo(batch);
   }
 
 
   void Block::onDraw(sf::RenderTarget &target, sf::RenderStates states) const
   {
-    if (gLocalSettings().useShaders())
-      states.shader = &mShader;
+    if (mShader != nullptr) {
+      mShader->setParameter("uAge", age().asSeconds());
+      mShader->setParameter("uBlur", mFalling ? 2.28f : 0.f);
+      mShader->setParameter("uColor", mFalling ? sf::Color(255U, 255U, 255U, 230U) : sf::Color(255U, 255U, 255U, 255U));
+      // blur offsets are relative to the whole texture, which may be the atlas
+      const sf::Vector2u &textureSize = mSprite.getTexture() != nullptr ? mSprite.getTexture()->getSize() : sf::Vector2u();
+      mShader->setParameter("uResolution", float(textureSize.x), float(textureSize.y));
+      states.shader = mShader;
+    }
     target.draw(mSprite, states);
   }
 
@@ -143,15 +160,10 @@ namespace Impact {
     const int v = int(impulse);
     bool destroyed = Body::hit(v);
     if (!destroyed && v > mMinimumHitImpulse) {
+      // called from inside the physics step, so the looks follow in onUpdate()
+      mFallRequested = true;
       mBody->SetLinearDamping(0.f);
       mBody->SetGravityScale(mGravityScale);
-      if (gLocalSettings().useShaders()) {
-        mShader.setParameter("uColor", sf::Color(sf::Color(255U, 255U, 255U, 230U)));
-        mShader.setParameter("uBlur", 2.28f);
-      }
-      else {
-        mSprite.setColor(sf::Color(255U, 255U, 255U, 160U));
-      }
     }
     return destroyed;
   }
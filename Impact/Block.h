@@ -34,6 +34,7 @@ namespace Impact {
     // Body implementation
     virtual void onUpdate(float elapsedSeconds);
     virtual void onDraw(sf::RenderTarget &target, sf::RenderStates states) const;
+    virtual bool addTo(SpriteBatch &batch) const;
 
     virtual bool hit(float impulse);
 
@@ -45,14 +46,13 @@ namespace Impact {
     static const float32 DefaultRestitution;
     static const float32 DefaultLinearDamping;
     static const float32 DefaultAngularDamping;
-
-  protected:
     static const int TextureMargin = 8;
 
-
   private:
     float32 mGravityScale;
     int mMinimumHitImpulse;
+    bool mFalling;
+    bool mFallRequested;
   };
 
 }
@@ -31,11 +31,15 @@ namespace Impact {
     , mVisible(true)
     , mZIndex(0)
     , mBody(nullptr)
+    , mShader(nullptr)
+    , mBatchable(false)
     , mSetHalfTextureSizeCalled(false)
     , mTileParam(tileParam)
+    , mPreviousAngle(0)
+    , mPreviousTransformValid(false)
   {
     setGame(game);
-    mSpawned.restart();
+    mSpawned = (mGame != nullptr) ? mGame->simulationTime() : sf::Time::Zero;
   }
 
 
@@ -48,14 +52,14 @@ namespace Impact {
   void Body::setGame(Game *game)
   {
     mGame = game;
-    if (mGame != nullptr)
-      doOnKilled(boost::bind(&Game::onBodyKilled, mGame, this));
   }
 
 
-  boost::signals2::connection Body::doOnKilled(const KilledSlotType &slot)
+  const sf::Time Body::age(void) const
   {
-    return signalKilled.connect(slot);
+    // measured in simulation time, so that lifetimes do not depend
+    // on the frame rate and replays reproduce the exact same run
+    return (mGame != nullptr) ? mGame->simulationTime() - mSpawned : sf::Time::Zero;
   }
 
 
@@ -71,9 +75,25 @@ namespace Impact {
   }
 
 
-  void Body::setSmooth(bool smooth)
+  bool Body::addTo(SpriteBatch &batch) const
   {
-    mTexture.setSmooth(smooth);
+    if (!mBatchable)
+      return false;
+    batch.add(mSprite);
+    return true;
+  }
+
+
+  bool Body::useAtlas(int index, int margin)
+  {
+    const TextureAtlas &atlas = mGame->level()->atlas();
+    mBatchable = atlas.contains(index);
+    if (mBatchable) {
+      const sf::IntRect &r = atlas.rect(index);
+      mSprite.setTexture(atlas.texture());
+      mSprite.setTextureRect(sf::IntRect(r.left - margin, r.top - margin, r.width + 2 * margin, r.height + 2 * margin));
+    }
+    return mBatchable;
   }
 
 
@@ -102,13 +122,20 @@ namespace Impact {
     if (!mSetHalfTextureSizeCalled)
       throw "Body::setHalfTextureSize() must be called before first call to Body::setPosition()";
     mBody->SetTransform(p + b2Vec2(mHalfTextureSize.x, 1 - mHalfTextureSize.y), mBody->GetAngle());
+    mPreviousTransformValid = false;
     onUpdate(0);
   }
 
 
   void Body::setHalfTextureSize(const sf::Texture &texture)
   {
-    mHalfTextureSize = .5f * b2Vec2(Game::InvScale * texture.getSize().x, Game::InvScale * texture.getSize().y);
+    setHalfTextureSize(texture.getSize());
+  }
+
+
+  void Body::setHalfTextureSize(const sf::Vector2u &textureSize)
+  {
+    mHalfTextureSize = .5f * b2Vec2(Game::InvScale * textureSize.x, Game::InvScale * textureSize.y);
     mSetHalfTextureSizeCalled = true;
   }
 
@@ -129,11 +156,24 @@ namespace Impact {
   }
 
 
+  void Body::revive(void)
+  {
+    mAlive = true;
+    mVisible = true;
+    mSpawned = (mGame != nullptr) ? mGame->simulationTime() : sf::Time::Zero;
+    mPreviousTransformValid = false;
+    mHandle = SlotHandle();
+  }
+
+
   void Body::kill(void)
   {
     mAlive = false;
+    if (mBody != nullptr)
+      mBody->SetActive(false);
     setVisible(false);
-    signalKilled(this);
+    if (mGame != nullptr)
+      mGame->postEvent(GameEvent(GameEvent::BodyKilled, mHandle));
   }
 
 
@@ -155,4 +195,35 @@ namespace Impact {
     mTileParam = param;
   }
 
+
+  void Body::saveTransform(void)
+  {
+    const b2Body *b = body();
+    if (b != nullptr) {
+      mPreviousPosition = b->GetPosition();
+      mPreviousAngle = b->GetAngle();
+      mPreviousTransformValid = true;
+    }
+  }
+
+
+  b2Vec2 Body::interpolatedPosition(void)
+  {
+    const b2Vec2 &current = body()->GetPosition();
+    if (!mPreviousTransformValid || mGame == nullptr)
+      return current;
+    const float32 alpha = mGame->interpolation();
+    return alpha * current + (1 - alpha) * mPreviousPosition;
+  }
+
+
+  float32 Body::interpolatedAngle(void)
+  {
+    const float32 current = body()->GetAngle();
+    if (!mPreviousTransformValid || mGame == nullptr)
+      return current;
+    const float32 alpha = mGame->interpolation();
+    return alpha * current + (1 - alpha) * mPreviousAngle;
+  }
+
 }
@@ -20,8 +20,6 @@
 #ifndef __BODY_H_
 #define __BODY_H_
 
-#include <boost/signals2.hpp>
-
 #include <SFML/Graphics.hpp>
 #include <SFML/System.hpp>
 #include <Box2D/Box2D.h>
@@ -29,6 +27,7 @@
 #include "Destructible.h"
 #include "util.h"
 #include "TileParam.h"
+#include "SlotMap.h"
 
 #include <cstdint>
 #include <vector>
@@ -38,6 +37,8 @@ namespace Impact {
   class Game;
 
 
+  class SpriteBatch;
+
   class Body : public sf::Drawable, public Destructible {
   public:
     typedef enum _BodyType {
@@ -60,7 +61,8 @@ namespace Impact {
       LeftBoundary,
       TopBoundary,
       RightBoundary,
-      BottomBoundary
+      BottomBoundary,
+      LastBodyType
     } BodyType;
 
     static const int16 DefaultCollisionGroup = 1;
@@ -75,13 +77,18 @@ namespace Impact {
     Body(BodyType, Game *game, const TileParam &tileParam = TileParam());
     virtual ~Body();
 
-    typedef boost::signals2::signal<void (Body*)> killed_signal_t;
-    typedef killed_signal_t::slot_type KilledSlotType;
-
-    boost::signals2::connection doOnKilled(const KilledSlotType &slot);
-
     void update(float elapsedSeconds);
     void draw(sf::RenderTarget& target, sf::RenderStates states) const;
+    /// Adds the body to a batch drawn from the level's texture atlas
+    /// instead of drawing it on its own. Returns false for bodies that
+    /// need their own texture or shader.
+    virtual bool addTo(SpriteBatch &batch) const;
+    /// Static bodies look the same from frame to frame, so they can be
+    /// drawn once into a cached layer.
+    virtual bool isStatic(void) const
+    {
+      return false;
+    }
 
     virtual void setDensity(float32);
 
@@ -99,24 +106,26 @@ namespace Impact {
       return mMaxAge;
     }
 
-    inline const sf::Time age(void) const
-    {
-      return mSpawned.getElapsedTime();
-    }
+    const sf::Time age(void) const;
 
     inline bool overAge(void) const
     {
       return age() > lifetime();
     }
+    /// bodies without a lifetime live until they are killed
+    inline bool hasLifetime(void) const
+    {
+      return mMaxAge > sf::Time::Zero;
+    }
 
     BodyType type(void) const
     {
       return mBodyType;
     }
 
-    inline const sf::Texture &texture(void) const
+    inline const std::shared_ptr<sf::Texture> &texture(void) const
     {
-      return mTexture;
+      return mTileParam.texture;
     }
 
     virtual void remove(void);
@@ -127,13 +136,19 @@ namespace Impact {
       return mAlive;
     }
 
+    /// false once the body has left the physics world, which happens
+    /// in the step deciding its death, before kill() is called
+    inline bool isActive(void) const
+    {
+      return mBody != nullptr && mBody->IsActive();
+    }
+
     void setVisible(bool);
     inline bool isVisible(void) const
     {
       return mVisible;
     }
 
-    void setSmooth(bool);
 
     virtual void setGame(Game *);
     inline Game *game(void)
@@ -150,39 +165,63 @@ namespace Impact {
     void setTileParam(const TileParam &tileParam);
     const TileParam &tileParam(void) const { return mTileParam; }
 
-  protected:
-    Body::killed_signal_t signalKilled;
+    inline void setHandle(const SlotHandle &handle)
+    {
+      mHandle = handle;
+    }
+    inline const SlotHandle &handle(void) const
+    {
+      return mHandle;
+    }
 
-    sf::Texture mTexture;
+    void saveTransform(void);
+    b2Vec2 interpolatedPosition(void);
+    float32 interpolatedAngle(void);
+
+  protected:
     sf::Sprite mSprite;
-    sf::Shader mShader;
+    sf::Shader *mShader; // shared, see ShaderRegistry; uniforms are set when drawing
     b2Body *mBody;
     b2Vec2 mHalfTextureSize;
     BodyType mBodyType;
 
     int mZIndex;
-    sf::Clock mSpawned; // milliseconds
+    sf::Time mSpawned; // simulation time at creation
     sf::Time mMaxAge;
     Game *mGame;
 
     std::string mName;
 
+    /// May run on any thread, in parallel with the onUpdate() of other
+    /// bodies, so it must not touch anything but the body itself: no
+    /// GL calls, no kill(), no changes to the Box2D world.
     virtual void onUpdate(float elapsedSeconds) = 0;
     virtual void onDraw(sf::RenderTarget &target, sf::RenderStates states) const = 0;
 
     TileParam mTileParam;
 
     void setHalfTextureSize(const sf::Texture &texture);
+    void setHalfTextureSize(const sf::Vector2u &textureSize);
+    void revive(void);
+    bool useAtlas(int index, int margin = 0);
+
+    bool mBatchable;
 
   private:
     bool mAlive;
     bool mVisible;
 
     bool mSetHalfTextureSizeCalled;
+
+    b2Vec2 mPreviousPosition;
+    float32 mPreviousAngle;
+    bool mPreviousTransformValid;
+
+    SlotHandle mHandle;
   };
 
 
-  typedef std::vector<Body*> BodyList;
+  typedef SlotMap<Body*> BodyList;
   typedef std::vector<const Body*> ConstBodyList;
 
 }
@@ -0,0 +1,64 @@
+/*
+
+    Copyright (c) 2015 Oliver Lau <ola@ct.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#ifndef __BODYPOOL_H_
+#define __BODYPOOL_H_
+
+#include <vector>
+
+namespace Impact {
+
+  /// Recycles short-lived bodies instead of returning them to the heap.
+  /// T must provide a constructor and an init() method taking a D, and
+  /// a remove() method that gives back everything the body holds in
+  /// the Box2D world.
+  template <typename T, typename D>
+  class BodyPool {
+  public:
+    BodyPool(void)
+    { /* ... */ }
+    ~BodyPool()
+    {
+      for (typename std::vector<T*>::iterator t = mFree.begin(); t != mFree.end(); ++t)
+        delete *t;
+    }
+
+    T *acquire(const D &def)
+    {
+      if (mFree.empty())
+        return new T(def);
+      T *t = mFree.back();
+      mFree.pop_back();
+      t->init(def);
+      return t;
+    }
+
+    void release(T *t)
+    {
+      t->remove();
+      mFree.push_back(t);
+    }
+
+  private:
+    std::vector<T*> mFree;
+  };
+
+}
+
+#endif // __BODYPOOL_H_
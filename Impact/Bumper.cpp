@@ -31,12 +31,13 @@ namespace Impact {
     mName = Name;
     setScore(mTileParam.score);
 
-    mTexture = mGame->level()->tileParam(index).texture;
-    setSmooth(mTileParam.smooth);
-    mSprite.setTexture(mTexture);
-    mSprite.setOrigin(.5f * mTexture.getSize().x, .5f * mTexture.getSize().y);
+    const TileParam &tile = mGame->level()->tileParam(index);
+    if (!useAtlas(index)) {
+      mSprite.setTexture(*tile.texture);
+    }
+    mSprite.setOrigin(.5f * tile.textureSize.x, .5f * tile.textureSize.y);
 
-    setHalfTextureSize(mTexture);
+    setHalfTextureSize(tile.textureSize);
 
     b2BodyDef bd;
     bd.type = b2_staticBody;
@@ -44,7 +45,7 @@ namespace Impact {
     mBody = game->world()->CreateBody(&bd);
 
     b2CircleShape circle;
-    circle.m_radius = .5f * mTexture.getSize().x * Game::InvScale;
+    circle.m_radius = .5f * tile.textureSize.x * Game::InvScale;
 
     b2FixtureDef fd;
     fd.shape = &circle;
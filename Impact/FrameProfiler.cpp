@@ -0,0 +1,135 @@
+/*
+
+    Copyright (c) 2015 Oliver Lau <ola@ct.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+
+#include "stdafx.h"
+
+namespace Impact {
+
+  const char *FrameProfiler::PhaseNames[FrameProfiler::Phase::LastPhase] = {
+    "frame",
+    "events",
+    "simulation wait",
+    "step",
+    "step collide",
+    "step solve",
+    "step solveTOI",
+    "step broadphase",
+    "evaluateCollisions",
+    "update",
+    "updateParticles",
+    "drawPlayground",
+    "executeKeyhole",
+    "executeBlur",
+    "executePostEffects",
+    "display"
+  };
+
+
+  FrameProfiler::FrameProfiler(unsigned int historySize)
+    : mHistorySize(historySize)
+    , mFrameIndex(0)
+    , mFrameCount(0)
+    , mHistory(historySize * Phase::LastPhase, 0.f)
+  {
+    std::fill(mCurrent, mCurrent + Phase::LastPhase, 0.f);
+  }
+
+
+  void FrameProfiler::clear(void)
+  {
+    std::fill(mHistory.begin(), mHistory.end(), 0.f);
+    std::fill(mCurrent, mCurrent + Phase::LastPhase, 0.f);
+    mFrameIndex = 0;
+    mFrameCount = 0;
+  }
+
+
+  void FrameProfiler::beginFrame(void)
+  {
+    std::fill(mCurrent, mCurrent + Phase::LastPhase, 0.f);
+    mClocks[Phase::Frame].restart();
+  }
+
+
+  void FrameProfiler::endFrame(void)
+  {
+    end(Phase::Frame);
+    std::copy(mCurrent, mCurrent + Phase::LastPhase, mHistory.begin() + mFrameIndex * Phase::LastPhase);
+    mFrameIndex = (mFrameIndex + 1) % mHistorySize;
+    if (mFrameCount < mHistorySize)
+      ++mFrameCount;
+  }
+
+
+  void FrameProfiler::begin(Phase phase)
+  {
+    mClocks[phase].restart();
+  }
+
+
+  void FrameProfiler::end(Phase phase)
+  {
+    add(phase, 1e-3f * mClocks[phase].getElapsedTime().asMicroseconds());
+  }
+
+
+  void FrameProfiler::add(Phase phase, float milliseconds)
+  {
+    mCurrent[phase] += milliseconds;
+  }
+
+
+  float FrameProfiler::percentile(Phase phase, float p) const
+  {
+    if (mFrameCount == 0)
+      return 0.f;
+    std::vector<float> samples(mFrameCount);
+    for (unsigned int i = 0; i < mFrameCount; ++i)
+      samples[i] = mHistory[i * Phase::LastPhase + phase];
+    const std::vector<float>::size_type n = std::vector<float>::size_type(.01f * p * (mFrameCount - 1) + .5f);
+    std::nth_element(samples.begin(), samples.begin() + n, samples.end());
+    return samples[n];
+  }
+
+
+  bool FrameProfiler::exportCSV(const std::string &filename) const
+  {
+    std::ofstream os(filename);
+    if (!os.is_open()) {
+      std::cerr << "Cannot open " << filename << " for writing" << std::endl;
+      return false;
+    }
+    os << "frame";
+    for (int phase = Phase::Frame; phase < Phase::LastPhase; ++phase)
+      os << "," << PhaseNames[phase] << " [ms]";
+    os << std::endl;
+    // oldest frame first
+    const unsigned int first = (mFrameCount < mHistorySize) ? 0 : mFrameIndex;
+    for (unsigned int i = 0; i < mFrameCount; ++i) {
+      const unsigned int row = (first + i) % mHistorySize;
+      os << i;
+      for (int phase = Phase::Frame; phase < Phase::LastPhase; ++phase)
+        os << "," << mHistory[row * Phase::LastPhase + phase];
+      os << std::endl;
+    }
+    return os.good();
+  }
+
+}
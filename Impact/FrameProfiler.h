@@ -0,0 +1,86 @@
+/*
+
+    Copyright (c) 2015 Oliver Lau <ola@ct.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#ifndef __FRAMEPROFILER_H_
+#define __FRAMEPROFILER_H_
+
+#include <SFML/System.hpp>
+
+#include <string>
+#include <vector>
+
+namespace Impact {
+
+  /// Collects per-phase timings over a rolling window of frames.
+  class FrameProfiler {
+  public:
+    typedef enum _Phase {
+      /* !!! DO NOT FORGET TO CHANGE FrameProfiler::PhaseNames WHEN MAKING CHANGES HERE !!! */
+      Frame,
+      EventPolling,
+      SimulationWait,
+      Step,
+      StepCollide,
+      StepSolve,
+      StepSolveTOI,
+      StepBroadphase,
+      EvaluateCollisions,
+      UpdateBodies,
+      UpdateParticles,
+      DrawPlayground,
+      ExecuteKeyhole,
+      ExecuteBlur,
+      ExecutePostEffects,
+      Display,
+      LastPhase
+    } Phase;
+
+    static const char *PhaseNames[Phase::LastPhase];
+    static const unsigned int DefaultHistorySize = 256U;
+
+    FrameProfiler(unsigned int historySize = DefaultHistorySize);
+
+    void clear(void);
+    void beginFrame(void);
+    void endFrame(void);
+    void begin(Phase);
+    void end(Phase);
+    void add(Phase, float milliseconds);
+
+    /// p-th percentile (0..100) of a phase over the recorded frames in milliseconds
+    float percentile(Phase, float p) const;
+    inline unsigned int frameCount(void) const
+    {
+      return mFrameCount;
+    }
+
+    bool exportCSV(const std::string &filename) const;
+
+  private:
+    unsigned int mHistorySize;
+    unsigned int mFrameIndex;
+    unsigned int mFrameCount;
+    std::vector<float> mHistory;
+    float mCurrent[Phase::LastPhase];
+    sf::Clock mClocks[Phase::LastPhase];
+  };
+
+}
+
+#endif // __FRAMEPROFILER_H_
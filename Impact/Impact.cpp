@@ -96,6 +96,8 @@ namespace Impact {
   const int64_t Game::NewLifeAfterSoManyPointsDefault = 100000LL; //MOD Extraball
   const int Game::DefaultForceNewBallPenalty = 500;
   const sf::Time Game::DefaultPenaltyInterval = sf::milliseconds(100); //MOD Strafe
+  const int Game::MaxPhysicsStepsPerFrame = 8; //MOD Physik
+  const unsigned int Game::DefaultHeadlessTicks = 5 * 60 * 120; // five minutes at 120 Hz
 
   const sf::Time Game::DefaultFadeEffectDuration = sf::milliseconds(150);
   const sf::Time Game::DefaultAberrationEffectDuration = sf::milliseconds(250);
@@ -120,13 +122,16 @@ namespace Impact {
   };
 #endif
 
-  Game::Game(void)
-    : mWorld(nullptr)
+  Game::Game(bool headless)
+    : mHeadless(headless)
+    , mWorld(nullptr)
+    , mStaticLayerValid(false)
     , mDisplayCount(0)
     , mBallHasBeenLost(false)
     , mRacket(nullptr)
     , mGround(nullptr)
-    , mContactPointCount(0)
+    , mStepProfile()
+    , mCollisionProfile(0.f)
     , mLevelScore(0)
     , mNewHighscore(false)
     , mLives(DefaultLives)
@@ -146,18 +151,30 @@ namespace Impact {
     , mScaleGravityEnabled(false)
     , mScaleBallDensityEnabled(false)
     , mAberrationIntensity(0.f)
+    , mAberrationCenter(.5f, .5f)
+    , mColorMix(255U, 255U, 255U, 255U)
+    , mColorAdd(0U, 0U, 0U, 0U)
+    , mColorSub(0U, 0U, 0U, 0U)
     , mBlurPlayground(false)
     , mKeyholeEffect(false)
     , mVignettizePlayground(false)
     , mHSVShift(sf::Vector3f(1.f, 1.f, 1.f))
     , mOverlayDuration(DefaultOverlayDuration)
     , mLastKillingsIndex(0)
-    , mMusic(Music::LastMusic)
-    , mSoundFX(MaxSoundFX)
     , mSoundIndex(0)
     , mFPSArray(32, 0)
     , mFPS(0)
     , mFPSIndex(0)
+    , mProfilerVisible(false)
+    , mInterpolation(1.f)
+    , mTick(0)
+    , mReplayRecording(false)
+    , mReplayPlayback(false)
+    , mCursorOnRacketRequested(false)
+    , mSimulationSteps(0)
+    , mSimulationBusy(false)
+    , mSimulationPending(false)
+    , mQuitSimulation(false)
 #if defined(WIN32)
     , mMyProcessHandle(0)
 #endif
@@ -166,7 +183,7 @@ namespace Impact {
     , mGLVersionMinor(0)
     , mGLSLVersionMajor(0)
     , mGLSLVersionMinor(0)
-    , mShadersAvailable(sf::Shader::isAvailable())
+    , mShadersAvailable(!headless && sf::Shader::isAvailable())
     , mQuitEnumeration(false)
     , mHighscoreReached(false)
 #ifndef NO_RECORDER
@@ -176,6 +193,22 @@ namespace Impact {
   {
     bool ok;
 
+    initCollisionHandlers();
+    mContacts.reserve(InitialContactCapacity);
+    mEvents.reserve(InitialEventCapacity);
+    mContactOrder.reserve(InitialContactCapacity);
+    std::fill(mPostEffectShaders, mPostEffectShaders + PostEffectVariants, static_cast<sf::Shader*>(nullptr));
+
+    if (mHeadless) {
+      // no window, no GL context, no audio: just the physics and the game logic
+      gLocalSettings().setUseShaders(false);
+      gLocalSettings().setUseShadersForExplosions(false);
+      mLevel.setHeadless(true);
+      warmupRNG();
+      resize();
+      return;
+    }
+
     glewInit();
     glGetIntegerv(GL_MAJOR_VERSION, &mGLVersionMajor);
     glGetIntegerv(GL_MINOR_VERSION, &mGLVersionMinor);
@@ -230,6 +263,9 @@ namespace Impact {
       std::cerr << FontsDir + "/Dimitri.ttf failed to load." << std::endl;
 
     mParticleTexture.loadFromFile(ImagesDir + "/round-soft-particle.png"); //MOD Explosionspartikel
+    mParticleTexture.setRepeated(false);
+    mParticleTexture.setSmooth(true);
+    mParticleSystem.setTexture(&mParticleTexture);
 
     mNewHighscoreMsg.setString(tr("New Highscore"));
     mNewHighscoreMsg.setFont(mFixedFont);
@@ -284,6 +320,10 @@ namespace Impact {
     mFPSText.setFont(mFixedFont);
     mFPSText.setCharacterSize(8U);
 
+    mProfilerText.setFont(mFixedFont);
+    mProfilerText.setCharacterSize(8U);
+    mProfilerText.setPosition(180.f, 4.f);
+
     mBackgroundTexture.loadFromFile(ImagesDir + "/welcome-background.jpg");
     mBackgroundSprite.setTexture(mBackgroundTexture);
     mBackgroundSprite.setPosition(0.f, 0.f);
@@ -358,6 +398,9 @@ namespace Impact {
 
     restart();
 
+    if (gLocalSettings().simulationThread())
+      mSimulationThread = std::thread(&Game::simulationThreadProc, this);
+
     mRecorderClock.restart();
 
 #ifndef NO_RECORDER
@@ -394,7 +437,18 @@ namespace Impact {
       delete mRec;
     }
 #endif
-    gLocalSettings().save();
+    if (mSimulationThread.joinable()) {
+      waitForSimulation();
+      {
+        std::unique_lock<std::mutex> lock(mSimulationMutex);
+        mQuitSimulation = true;
+        mSimulationCondition.notify_all();
+      }
+      mSimulationThread.join();
+    }
+    finishReplayRecording();
+    if (!mHeadless)
+      gLocalSettings().save();
     clearWorld();
   }
 
@@ -403,6 +457,11 @@ namespace Impact {
   {
     bool ok;
 
+    // sf::Sound and sf::Music grab an audio device on construction,
+    // so they are created here instead of in the constructor's initializer list
+    std::vector<sf::Music>(Music::LastMusic).swap(mMusic);
+    std::vector<sf::Sound>(MaxSoundFX).swap(mSoundFX);
+
     setSoundFXVolume(gLocalSettings().soundFXVolume());
     setMusicVolume(gLocalSettings().musicVolume());
 
@@ -547,34 +606,33 @@ namespace Impact {
       mTitleTexture = titleRenderTexture.getTexture();
       mTitleTexture.setSmooth(true);
       mTitleSprite.setTexture(mTitleTexture);
-      ok = mAberrationShader.loadFromFile(ShadersDir + "/aberration.fs", sf::Shader::Fragment);
-      if (!ok)
-        std::cerr << ShadersDir + "/aberration.fs" << " failed to load/compile." << std::endl;
-      mAberrationShader.setParameter("uCenter", sf::Vector2f(.5f, .5f));
-      ok = mMixShader.loadFromFile(ShadersDir + "/mix.fs", sf::Shader::Fragment);
-      if (!ok)
-        std::cerr << ShadersDir + "/mix.fs" << " failed to load/compile." << std::endl;
-      ok = mVBlurShader.loadFromFile(ShadersDir + "/vblur.fs", sf::Shader::Fragment);
+      // compile every combination up front, so that an effect kicking in doesn't stall the game
+      for (unsigned int effects = 0; effects < MixEffect; ++effects)
+        mPostEffectShaders[effects | MixEffect] = postEffectShader(effects | MixEffect);
+      mPostEffectShaders[VignetteEffect] = postEffectShader(VignetteEffect);
+      ok = mBlurDownShader.loadFromFile(ShadersDir + "/blurdown.fs", sf::Shader::Fragment);
       if (!ok)
-        std::cerr << ShadersDir + "/vblur.fs" << " failed to load/compile." << std::endl;
-      mVBlurShader.setParameter("uBlur", 4.f);
-      mVBlurShader.setParameter("uResolution", windowSize);
-      ok = mHBlurShader.loadFromFile(ShadersDir + "/hblur.fs", sf::Shader::Fragment);
+        std::cerr << ShadersDir + "/blurdown.fs" << " failed to load/compile." << std::endl;
+      ok = mBlurUpShader.loadFromFile(ShadersDir + "/blurup.fs", sf::Shader::Fragment);
       if (!ok)
-        std::cerr << ShadersDir + "/hblur.fs" << " failed to load/compile." << std::endl;
-      mHBlurShader.setParameter("uBlur", 4.f);
-      mHBlurShader.setParameter("uResolution", windowSize);
+        std::cerr << ShadersDir + "/blurup.fs" << " failed to load/compile." << std::endl;
       ok = mTitleShader.loadFromFile(ShadersDir + "/title.fs", sf::Shader::Fragment);
       if (!ok)
         std::cerr << ShadersDir + "/title.fs" << " failed to load/compile." << std::endl;
       mTitleShader.setParameter("uResolution", windowSize);
-      ok = mEarthquakeShader.loadFromFile(ShadersDir + "/earthquake.fs", sf::Shader::Fragment);
-      if (!ok)
-        std::cerr << ShadersDir + "/earthquake.fs" << " failed to load/compile." << std::endl;
       ok = mOverlayShader.loadFromFile(ShadersDir + "/overlay.fs", sf::Shader::Fragment);
       if (!ok)
         std::cerr << ShadersDir + "/overlay.fs" << " failed to load/compile." << std::endl;
       mOverlayShader.setParameter("uResolution", windowSize);
+      ok = mParticleShader.loadFromFile(ShadersDir + "/explosion.fs", sf::Shader::Fragment);
+      if (ok) {
+        mParticleShader.setParameter("uTexture", sf::Shader::CurrentTexture);
+        mParticleSystem.setShader(&mParticleShader);
+      }
+      else {
+        // without a shader the particle system draws plain quads
+        std::cerr << ShadersDir + "/explosion.fs" << " failed to load/compile." << std::endl;
+      }
 
       ok = mKeyholeShader.loadFromFile(ShadersDir + "/keyhole.fs", sf::Shader::Fragment);
       if (!ok)
@@ -582,13 +640,6 @@ namespace Impact {
       mKeyholeShader.setParameter("uStretch", 0.5f); //MOD Stretch
       mKeyholeShader.setParameter("uSharpness", 2.0f); //MOD Sharpness
       mKeyholeShader.setParameter("uAspect", mDefaultView.getSize().y / mDefaultView.getSize().x);
-      mKeyholeShader.setParameter("uCenter", sf::Vector2f(.5f, .5f));
-
-      ok = mVignetteShader.loadFromFile(ShadersDir + "/vignette.fs", sf::Shader::Fragment);
-      if (!ok)
-        std::cerr << ShadersDir + "/vignette.fs" << " failed to load/compile." << std::endl;
-      mVignetteShader.setParameter("uStretch", 1.0f);
-      mVignetteShader.setParameter("uHSV", mHSVShift);
     }
 
     mMenuParticlesPerExplosionText = sf::Text(tr("Particles per explosion"), mFixedFont, 16U);
@@ -750,13 +801,11 @@ namespace Impact {
     mBallHasBeenLost = false;
     mLevel.set(0, false);
 
-    mContactPointCount = 0;
+    mContacts.clear();
 
-    if (gLocalSettings().useShaders()) {
-      mMixShader.setParameter("uColorMix", sf::Color(255U, 255U, 255U, 255U));
-      mMixShader.setParameter("uColorAdd", sf::Color(0U, 0U, 0U, 0U));
-      mMixShader.setParameter("uColorSub", sf::Color(0U, 0U, 0U, 0U));
-    }
+    mColorMix = sf::Color(255U, 255U, 255U, 255U);
+    mColorAdd = sf::Color(0U, 0U, 0U, 0U);
+    mColorSub = sf::Color(0U, 0U, 0U, 0U);
 
     resume();
     gotoWelcomeScreen();
@@ -766,7 +815,13 @@ namespace Impact {
 
   void Game::clearWorld(void)
   {
+    waitForSimulation();
+    mSimulationPending = false;
+    mEvents.clear();
     mBalls.clear();
+    mBallPositions.clear();
+    mParticleSystem.clear();
+    mStaticLayerValid = false;
     if (mWorld != nullptr) {
       b2Body *node = mWorld->GetBodyList();
       while (node) {
@@ -829,7 +884,10 @@ namespace Impact {
     mRecorderWallClock.restart();
 
     while (mWindow.isOpen()) {
+      TRACE_SCOPE("Game::loop");
       mElapsed = mClock.restart();
+      mProfiler.beginFrame();
+      mParticleSystem.setFrameTime(mElapsed, sf::microseconds(1000000 / (gLocalSettings().framerateLimit() > 0 ? gLocalSettings().framerateLimit() : TargetFramerate)));
 
 #ifndef NO_RECORDER
       if (mRecorderEnabled) {
@@ -890,7 +948,13 @@ namespace Impact {
         break;
       }
 
-      mWindow.display();
+      mProfiler.begin(FrameProfiler::Display);
+      {
+        TRACE_SCOPE("display");
+        mWindow.display();
+      }
+      mProfiler.end(FrameProfiler::Display);
+      mProfiler.endFrame();
 
 #ifdef CT_VERSION_INTERNAL
       if (!mLevelZipFilename.empty()) {
@@ -946,6 +1010,361 @@ namespace Impact {
   }
 
 
+  bool Game::runHeadless(const std::string &zipFilename, unsigned int maxTicks)
+  {
+    mLevel.loadZip(zipFilename);
+    if (!mLevel.isAvailable()) {
+      std::cerr << "Cannot load level from " << zipFilename << std::endl;
+      return false;
+    }
+
+    startHeadlessLevel();
+
+    // every call to update() advances the simulation by exactly one tick
+    const int tickRate = gLocalSettings().physicsTickRate() > 0 ? gLocalSettings().physicsTickRate() : 120;
+    mElapsed = sf::microseconds(1000000 / tickRate);
+    mPhysicsAccumulator = sf::Time::Zero;
+
+    unsigned int ticks = 0;
+    while (mState == State::Playing && ticks < maxTicks) {
+      if (mBalls.empty())
+        newBall();
+      if (mRacket != nullptr) {
+        // keep the racket below the first ball
+        const Ball *ball = reinterpret_cast<Ball*>(body(mBalls.front()));
+        mRacket->moveTo(b2Vec2(ball->position().x, mRacket->position().y));
+      }
+      update();
+      ++ticks;
+    }
+
+    printHeadlessReport(ticks);
+    return true;
+  }
+
+
+  bool Game::runHeadlessReplay(const std::string &replayFilename)
+  {
+    if (!loadReplay(replayFilename))
+      return false;
+
+    // the physics settings are part of the recording; they are not
+    // saved back to disk in headless mode, so they can be applied as is
+    const Replay::Header &header = mReplay.header();
+    gLocalSettings().setPhysicsTickRate(header.tickRate);
+    gLocalSettings().setVelocityIterations(header.velocityIterations);
+    gLocalSettings().setPositionIterations(header.positionIterations);
+    gLocalSettings().setParticlesPerExplosion(header.particlesPerExplosion);
+
+    startHeadlessLevel();
+    seedRNG(header.seed);
+    mReplayPlayback = true;
+
+    const sf::Time timeStep = sf::microseconds(1000000 / header.tickRate);
+    mElapsed = timeStep;
+    while (mState == State::Playing && !mReplay.atEnd()) {
+      const ReplayFrame &input = mReplay.current();
+      if (input.tick != mTick)
+        std::cerr << "Replay out of sync: expected tick " << input.tick << ", got " << mTick << std::endl;
+      applyInput(input);
+      mReplay.next();
+      advance(input.steps, timeStep, 1e-6f * timeStep.asMicroseconds());
+    }
+    mReplayPlayback = false;
+
+    printHeadlessReport(mTick);
+    return true;
+  }
+
+
+  bool Game::runBenchmark(const std::string &outputFilename, const std::string &baselineFilename, unsigned int ticks)
+  {
+    Benchmark baseline;
+    if (!baselineFilename.empty() && !baseline.load(baselineFilename))
+      return false;
+
+    const std::vector<std::string> &levelFiles = Benchmark::levelFiles();
+    if (levelFiles.empty()) {
+      std::cerr << "No levels found to benchmark" << std::endl;
+      return false;
+    }
+
+    Benchmark benchmark;
+    for (std::vector<std::string>::const_iterator f = levelFiles.cbegin(); f != levelFiles.cend(); ++f) {
+      BenchmarkResult result;
+      if (!benchmarkLevel(*f, ticks, result))
+        continue;
+      std::cout << std::left << std::setw(40) << result.zipFilename << std::right << std::fixed << std::setprecision(3)
+        << " load " << result.loadMs << " ms, build " << result.buildMs
+        << " ms, step " << result.meanStepMs << "/" << result.p99StepMs << " ms (mean/p99)" << std::endl;
+      benchmark.add(result);
+    }
+    clearWorld();
+
+    if (!benchmark.save(outputFilename))
+      return false;
+    if (baselineFilename.empty())
+      return true;
+    return benchmark.compare(baseline, std::cout);
+  }
+
+
+  bool Game::benchmarkLevel(const std::string &zipFilename, unsigned int ticks, BenchmarkResult &result)
+  {
+    result.zipFilename = zipFilename;
+
+    sf::Clock clock;
+    mLevel.loadZip(zipFilename);
+    result.loadMs = 1e-3 * clock.getElapsedTime().asMicroseconds();
+    if (!mLevel.isAvailable()) {
+      std::cerr << "Cannot load level from " << zipFilename << std::endl;
+      return false;
+    }
+    result.name = mLevel.name();
+    result.sha1 = mLevel.hash();
+
+    // every run starts from the same state so that consecutive runs
+    // are comparable
+    seedRNG(Benchmark::Seed);
+    clock.restart();
+    startHeadlessLevel();
+    result.buildMs = 1e-3 * clock.getElapsedTime().asMicroseconds();
+
+    const int tickRate = gLocalSettings().physicsTickRate() > 0 ? gLocalSettings().physicsTickRate() : 120;
+    const sf::Time timeStep = sf::microseconds(1000000 / tickRate);
+    mElapsed = timeStep;
+    std::vector<double> stepTimes;
+    stepTimes.reserve(ticks);
+    while (mState == State::Playing && stepTimes.size() < ticks) {
+      // scripted input: keep the racket below the first ball and kick
+      // to alternating sides every 90 ticks
+      ReplayFrame input;
+      input.tick = mTick;
+      input.steps = 1;
+      if (mBalls.empty())
+        input.input |= ReplayFrame::NewBall;
+      if (mRacket != nullptr) {
+        const float32 x = mBalls.empty() ? mRacket->position().x : body(mBalls.front())->position().x;
+        input.x = int16_t(Scale * x);
+        input.y = int16_t(Scale * mRacket->position().y);
+        if (mTick % 90 < 8)
+          input.input |= ((mTick / 90) % 2 == 0) ? ReplayFrame::KickLeft : ReplayFrame::KickRight;
+      }
+      applyInput(input);
+      clock.restart();
+      advance(1, timeStep, 1e-6f * timeStep.asMicroseconds());
+      stepTimes.push_back(1e-3 * clock.getElapsedTime().asMicroseconds());
+      result.peakBodies = std::max(result.peakBodies, unsigned(mBodies.size()));
+      result.peakContacts = std::max(result.peakContacts, unsigned(mWorld->GetContactCount()));
+    }
+
+    result.ticks = unsigned(stepTimes.size());
+    if (!stepTimes.empty()) {
+      result.meanStepMs = std::accumulate(stepTimes.cbegin(), stepTimes.cend(), 0.) / stepTimes.size();
+      const std::vector<double>::size_type n = (stepTimes.size() - 1) * 99 / 100;
+      std::nth_element(stepTimes.begin(), stepTimes.begin() + n, stepTimes.end());
+      result.p99StepMs = stepTimes[n];
+    }
+    result.peakRSSKB = Benchmark::peakRSS();
+    return true;
+  }
+
+
+  bool Game::startHeadlessLevel(void)
+  {
+    clearWorld();
+    safeRenew(mWorld, new b2World(b2Vec2(0.f, DefaultGravity)));
+    mWorld->SetAllowSleeping(true);
+    mWorld->SetWarmStarting(true);
+    mWorld->SetContinuousPhysics(false);
+    mWorld->SetContactListener(this);
+    mWorld->SetSubStepping(true);
+
+    mPlaymode = Playmode::SingleLevel;
+    mExtraLifeIndex = 0;
+    mLives = DefaultLives;
+    mLevelScore = 0;
+    mBallHasBeenLost = false;
+    mSimulationTime = sf::Time::Zero;
+    mTick = 0;
+    mLastPenalty = sf::Time::Zero;
+    buildLevel();
+    resetKillingSpree();
+    mLevelTimer.restart();
+    setState(State::Playing);
+    return true;
+  }
+
+
+  void Game::printHeadlessReport(unsigned int ticks)
+  {
+    const int tickRate = gLocalSettings().physicsTickRate() > 0 ? gLocalSettings().physicsTickRate() : 120;
+    const char *result = "timeout";
+    if (mState == State::LevelCompleted)
+      result = "level completed";
+    else if (mState == State::GameOver)
+      result = "game over";
+    std::cout
+      << "level:  " << mLevel.name() << std::endl
+      << "sha1:   " << mLevel.hash() << std::endl
+      << "result: " << result << std::endl
+      << "ticks:  " << ticks << " (" << ticks / tickRate << "s at " << tickRate << " Hz)" << std::endl
+      << "score:  " << mLevelScore << std::endl
+      << "blocks: " << mBlockCount << std::endl
+      << "lives:  " << (mState == State::GameOver ? 0U : mLives) << std::endl;
+  }
+
+
+  bool Game::loadReplay(const std::string &replayFilename)
+  {
+    if (!mReplay.load(replayFilename))
+      return false;
+    const Replay::Header &header = mReplay.header();
+    if (header.tickRate <= 0) {
+      std::cerr << replayFilename << " was not recorded at a fixed tick rate" << std::endl;
+      return false;
+    }
+    mLevel.set(header.levelNum, false);
+    mLevel.loadZip(header.zipFilename);
+    if (!mLevel.isAvailable()) {
+      std::cerr << "Cannot load level " << header.zipFilename << " for replay" << std::endl;
+      return false;
+    }
+    if (mLevel.hash() != header.levelHash) {
+      std::cerr << "Level " << header.zipFilename << " has changed since the replay was recorded (SHA1 "
+        << mLevel.hash() << " instead of " << header.levelHash << ")" << std::endl;
+      return false;
+    }
+    return true;
+  }
+
+
+  bool Game::playReplay(const std::string &replayFilename)
+  {
+    if (!loadReplay(replayFilename))
+      return false;
+    const Replay::Header &header = mReplay.header();
+    if (header.tickRate != gLocalSettings().physicsTickRate()
+      || header.velocityIterations != gLocalSettings().velocityIterations()
+      || header.positionIterations != gLocalSettings().positionIterations()) {
+      std::cerr << "Warning: " << replayFilename << " was recorded with different physics settings, playback will diverge." << std::endl;
+    }
+    mPlaymode = Playmode::SingleLevel;
+    mReplayPlayback = true;
+    gotoCurrentLevel();
+    return mReplayPlayback;
+  }
+
+
+  void Game::playbackReplay(void)
+  {
+    mProfiler.begin(FrameProfiler::EventPolling);
+    sf::Event event;
+    while (mWindow.pollEvent(event)) {
+      switch (event.type)
+      {
+      case sf::Event::Closed:
+        mWindow.close();
+        break;
+      case sf::Event::LostFocus:
+        gotoPausing();
+        break;
+      case sf::Event::GainedFocus:
+        resume();
+        break;
+      case sf::Event::KeyPressed:
+        if (event.key.code == mKeyMapping[PauseAction]) {
+          if (!mPaused)
+            gotoPausing();
+          else
+            resume();
+        }
+        else if (event.key.code == sf::Keyboard::F3) {
+          mProfilerVisible = !mProfilerVisible;
+        }
+        else if (event.key.code == sf::Keyboard::F4) {
+          exportProfile();
+        }
+        break;
+      default:
+        break;
+      }
+    }
+    mProfiler.end(FrameProfiler::EventPolling);
+
+    if (mState != State::Playing || mElapsed == sf::Time::Zero)
+      return;
+
+    // consume recorded frames as soon as the wall clock has caught up
+    // with the number of physics steps they stand for
+    const sf::Time timeStep = sf::microseconds(1000000 / mReplay.header().tickRate);
+    const float elapsedSeconds = 1e-6f * mElapsed.asMicroseconds();
+    mPhysicsAccumulator = std::min(mPhysicsAccumulator + mElapsed, sf::Int64(MaxPhysicsStepsPerFrame) * timeStep);
+    while (mReplayPlayback && mState == State::Playing && !mReplay.atEnd()) {
+      const ReplayFrame &input = mReplay.current();
+      const sf::Time due = sf::Int64(input.steps) * timeStep;
+      if (due > mPhysicsAccumulator)
+        break;
+      if (input.tick != mTick)
+        std::cerr << "Replay out of sync: expected tick " << input.tick << ", got " << mTick << std::endl;
+      mPhysicsAccumulator -= due;
+      applyInput(input);
+      mReplay.next();
+      advance(input.steps, timeStep, elapsedSeconds);
+    }
+    mInterpolation = std::min(1.f, mPhysicsAccumulator / timeStep);
+    advance(0, timeStep, elapsedSeconds);
+    measureFPS();
+
+    if (mReplayPlayback && mReplay.atEnd()) {
+      // hand the game over to the player
+      stopReplayPlayback();
+      setCursorOnRacket();
+    }
+  }
+
+
+  void Game::stopReplayPlayback(void)
+  {
+    mReplayPlayback = false;
+  }
+
+
+  void Game::startReplayRecording(void)
+  {
+    mReplayRecording = gLocalSettings().recordReplays() && gLocalSettings().physicsTickRate() > 0 && !mReplayPlayback;
+    if (!mReplayRecording)
+      return;
+    mReplay.clear();
+    Replay::Header &header = mReplay.header();
+    header.tickRate = gLocalSettings().physicsTickRate();
+    header.velocityIterations = gLocalSettings().velocityIterations();
+    header.positionIterations = gLocalSettings().positionIterations();
+    header.particlesPerExplosion = int32_t(gLocalSettings().particlesPerExplosion());
+    header.levelNum = mLevel.num();
+    header.levelHash = mLevel.hash();
+    header.zipFilename = mLevel.zipFilename();
+  }
+
+
+  void Game::finishReplayRecording(void)
+  {
+    if (!mReplayRecording)
+      return;
+    mReplayRecording = false;
+    if (mReplay.isEmpty())
+      return;
+    boost::system::error_code ec;
+    boost::filesystem::create_directories(gLocalSettings().replaysDir(), ec);
+    const std::string &replayFilename = gLocalSettings().replaysDir() + "/" + mLevel.name() + "-" + timestamp() + Replay::FileExtension;
+    if (mReplay.save(replayFilename)) {
+#ifndef NDEBUG
+      std::cout << "Replay saved to " << replayFilename << std::endl;
+#endif
+    }
+  }
+
+
   inline void Game::clearWindow(void)
   {
     mWindow.clear(mLevel.backgroundColor());
@@ -1011,6 +1430,8 @@ namespace Impact {
 
   void Game::gotoWelcomeScreen(void) 
   {
+    finishReplayRecording();
+    stopReplayPlayback();
     clearWorld();
     stopAllMusic();
     playSound(mStartupSound);
@@ -1031,6 +1452,7 @@ namespace Impact {
 
   void Game::onWelcomeScreen(void)
   {
+    TRACE_SCOPE("Game::onWelcomeScreen");
     const sf::Vector2f &mousePos = getCursorPosition();
     sf::Event event;
     while (mWindow.pollEvent(event)) {
@@ -1096,11 +1518,10 @@ namespace Impact {
       mWindow.draw(mWarningText);
 
     if (mWelcomeLevel == 0) {
-      ExplosionDef pd(this, b2Vec2(.5f * DefaultTilesHorizontally, .4f * DefaultTilesVertically));
+      ExplosionDef pd(b2Vec2(.5f * DefaultTilesHorizontally, .4f * DefaultTilesVertically));
       pd.ballCollisionEnabled = false;
       pd.count = gLocalSettings().particlesPerExplosion();
-      pd.texture = mParticleTexture;
-      addBody(new Explosion(pd));
+      addExplosion(pd);
       mWelcomeLevel = 1;
     }
 
@@ -1123,10 +1544,9 @@ namespace Impact {
       if (mWelcomeLevel == 1) {
         playSound(mExplosionSound, Game::InvScale * b2Vec2(mStartMsg.getPosition().x, mStartMsg.getPosition().y));
         mWelcomeLevel = 2;
-        ExplosionDef pd(this, Game::InvScale * b2Vec2(mStartMsg.getPosition().x, mStartMsg.getPosition().y)); //XXX
+        ExplosionDef pd(Game::InvScale * b2Vec2(mStartMsg.getPosition().x, mStartMsg.getPosition().y)); //XXX
         pd.count = gLocalSettings().particlesPerExplosion();
-        pd.texture = mParticleTexture;
-        addBody(new Explosion(pd));
+        addExplosion(pd);
       }
     }
     if (t > 550) {
@@ -1134,10 +1554,9 @@ namespace Impact {
       if (mWelcomeLevel == 2) {
         playSound(mExplosionSound, Game::InvScale * b2Vec2(mLogoSprite.getPosition().x, mLogoSprite.getPosition().y));
         mWelcomeLevel = 3;
-        ExplosionDef pd(this, Game::InvScale * b2Vec2(mLogoSprite.getPosition().x, mLogoSprite.getPosition().y));
+        ExplosionDef pd(Game::InvScale * b2Vec2(mLogoSprite.getPosition().x, mLogoSprite.getPosition().y));
         pd.count = gLocalSettings().particlesPerExplosion();
-        pd.texture = mParticleTexture;
-        addBody(new Explosion(pd));
+        addExplosion(pd);
       }
     }
     if (t > 670) {
@@ -1145,10 +1564,9 @@ namespace Impact {
       if (mWelcomeLevel == 3) {
         playSound(mExplosionSound, Game::InvScale * b2Vec2(mProgramInfoMsg.getPosition().x, mProgramInfoMsg.getPosition().y));
         mWelcomeLevel = 4;
-        ExplosionDef pd(this, Game::InvScale * b2Vec2(mProgramInfoMsg.getPosition().x, mProgramInfoMsg.getPosition().y));
-        pd.texture = mParticleTexture;
+        ExplosionDef pd(Game::InvScale * b2Vec2(mProgramInfoMsg.getPosition().x, mProgramInfoMsg.getPosition().y));
         pd.count = gLocalSettings().particlesPerExplosion();
-        addBody(new Explosion(pd));
+        addExplosion(pd);
       }
     }
 
@@ -1175,8 +1593,10 @@ namespace Impact {
 
   void Game::gotoLevelCompleted(void)
   {
+    finishReplayRecording();
     mTotalScore = deductPenalty(mLevelScore);
     checkHighscore();
+    stopReplayPlayback();
     playSound(mLevelCompleteSound);
     mStartMsg.setString(tr("Click to continue"));
     startBlurEffect();
@@ -1190,6 +1610,7 @@ namespace Impact {
 
   void Game::onLevelCompleted(void)
   {
+    TRACE_SCOPE("Game::onLevelCompleted");
     update();
     drawPlayground();
 
@@ -1236,6 +1657,7 @@ namespace Impact {
 
   void Game::onPlayerWon(void)
   {
+    TRACE_SCOPE("Game::onPlayerWon");
     update();
     drawPlayground();
 
@@ -1270,20 +1692,21 @@ namespace Impact {
 
   void Game::gotoGameOver(void)
   {
+    finishReplayRecording();
     mTotalScore = deductPenalty(mLevelScore);
     checkHighscore();
+    stopReplayPlayback();
     mStartMsg.setString(tr("Click to continue"));
     setState(State::GameOver);
     startBlurEffect();
-    if (gLocalSettings().useShaders()) {
-      mMixShader.setParameter("uColorMix", sf::Color(255U, 255U, 255U, 220U));
-    }
+    mColorMix = sf::Color(255U, 255U, 255U, 220U);
     mWindow.setFramerateLimit(DefaultFramerateLimit);
   }
 
 
   void Game::onGameOver(void)
   {
+    TRACE_SCOPE("Game::onGameOver");
     update();
     drawPlayground();
 
@@ -1321,6 +1744,7 @@ namespace Impact {
 
   void Game::onPausing(void)
   {
+    TRACE_SCOPE("Game::onPausing");
     drawPlayground();
 
     mWindow.setView(mPlaygroundView);
@@ -1365,13 +1789,12 @@ namespace Impact {
 
   void Game::gotoCurrentLevel(void)
   {
+    finishReplayRecording();
     stopAllMusic();
     clearWorld();
     mBallHasBeenLost = false;
     hideCursor();
-    if (gLocalSettings().useShaders()) {
-      mMixShader.setParameter("uColorMix", sf::Color(255U, 255U, 255U, 255U));
-    }
+    mColorMix = sf::Color(255U, 255U, 255U, 255U);
     mScaleGravityEnabled = false;
     mScaleBallDensityEnabled = false;
     mKeyholeEffect = false;
@@ -1390,6 +1813,9 @@ namespace Impact {
       mAberrationDuration = sf::Time::Zero;
       mAberrationIntensity = 0.f;
       mClock.restart();
+      mPhysicsAccumulator = sf::Time::Zero;
+      mSimulationTime = sf::Time::Zero;
+      mTick = 0;
       if (mLevel.music() != nullptr) {
         mLevel.music()->play();
         mLevel.music()->setVolume(gLocalSettings().musicVolume());
@@ -1397,10 +1823,22 @@ namespace Impact {
       else {
         playMusic(Game::Music(randomMusic(gRNG())));
       }
+      // from here on, the RNG only feeds the simulation, so seeding it
+      // at level start is all a replay needs to reproduce the run
+      if (mReplayPlayback) {
+        mReplay.rewind();
+        seedRNG(mReplay.header().seed);
+      }
+      else {
+        const uint32_t seed = std::random_device()();
+        seedRNG(seed);
+        startReplayRecording();
+        mReplay.header().seed = seed;
+      }
       setState(State::Playing);
       mLevelTimer.restart();
       mStatsClock.restart();
-      mPenaltyClock.restart();
+      mLastPenalty = sf::Time::Zero;
       mLevelScore = 0;
       mWindow.setFramerateLimit(gLocalSettings().framerateLimit());
     }
@@ -1421,6 +1859,24 @@ namespace Impact {
 
   void Game::onPlaying(void)
   {
+    TRACE_SCOPE("Game::onPlaying");
+    if (mReplayPlayback) {
+      playbackReplay();
+      drawPlayground();
+      return;
+    }
+
+    const float elapsedSeconds = 1e-6f * mElapsed.asMicroseconds();
+
+    // pick up the result of the steps started in the previous frame
+    finishSimulation(elapsedSeconds);
+    if (mState != State::Playing) {
+      drawPlayground();
+      return;
+    }
+
+    mProfiler.begin(FrameProfiler::EventPolling);
+    ReplayFrame input;
     sf::Event event;
     while (mWindow.pollEvent(event)) {
       switch (event.type)
@@ -1436,13 +1892,11 @@ namespace Impact {
         break;
       case sf::Event::MouseMoved:
         if (mScaleGravityEnabled && mScaleGravityClock.getElapsedTime() < mScaleGravityDuration) {
-          const sf::Vector2f &center = sf::Vector2f(float(event.mouseMove.x) / mDefaultView.getSize().x, float(event.mouseMove.y) / mDefaultView.getSize().y);
-          mAberrationShader.setParameter("uCenter", center);
+          mAberrationCenter = sf::Vector2f(float(event.mouseMove.x) / mDefaultView.getSize().x, float(event.mouseMove.y) / mDefaultView.getSize().y);
         }
         break;
       case sf::Event::MouseButtonPressed:
-        if (mBalls.empty())
-          newBall();
+        input.input |= ReplayFrame::NewBall;
         break;
       case sf::Event::KeyPressed:
         if (event.key.code == mKeyMapping[PauseAction]) {
@@ -1452,67 +1906,33 @@ namespace Impact {
             resume();
         }
         else if (event.key.code == sf::Keyboard::X) {
-          const b2Vec2 &racketPos = mRacket->position();
-          newBall(b2Vec2(racketPos.x, racketPos.y - 1.2f * sign(mLevel.gravity())));
+          input.input |= ReplayFrame::ExtraBall;
         }
         else if (event.key.code == mKeyMapping[RecoverBallAction] || event.key.code == sf::Keyboard::Space) {
-          if (mBalls.empty()) {
-            newBall();
-          }
-          else {
-            const b2Vec2 &padPos = mRacket->position();
-            for (std::vector<Ball*>::iterator b = mBalls.begin(); b != mBalls.end(); ++b) {
-              Ball *ball = *b;
-              ball->setPosition(b2Vec2(padPos.x, padPos.y - 3.5f));
-              showScore(-DefaultForceNewBallPenalty, ball->position());
-            }
-          }
+          input.input |= ReplayFrame::RecoverBall;
         }
-        break;
-      }
-    }
-
-    if (!mBalls.empty()) { // check if ball has been kicked out of the screen
-      for (std::vector<Ball*>::iterator b = mBalls.begin(); b != mBalls.end(); ++b) {
-        Ball *ball = *b;
-        if (ball != nullptr) {
-          const float ballX = ball->position().x;
-          const float ballY = ball->position().y;
-          if (0 > ballX || ballX > float(mLevel.width()) || 0 > ballY) {
-            ball->kill();
-          }
-          else if (ballY > mLevel.height()) {
-            ball->lethalHit();
-            ball->kill();
-          }
+        else if (event.key.code == sf::Keyboard::F3) {
+          mProfilerVisible = !mProfilerVisible;
+        }
+        else if (event.key.code == sf::Keyboard::F4) {
+          exportProfile();
         }
+        break;
       }
     }
 
     if (mRacket != nullptr) {
       if (sf::Mouse::isButtonPressed(sf::Mouse::Left)) {
-        mRacket->kickLeft();
+        input.input |= ReplayFrame::KickLeft;
       }
       else if (sf::Mouse::isButtonPressed(sf::Mouse::Right)) {
-        mRacket->kickRight();
-      }
-      else {
-        mRacket->stopKick();
+        input.input |= ReplayFrame::KickRight;
       }
 
       sf::Vector2i mousePos = sf::Mouse::getPosition(mWindow);
 
       if (mFPS < 200) {
-        // check if racket has been kicked out of the screen
-        const float racketX = mRacket->position().x;
-        const float racketY = mRacket->position().y;
-        if (racketY > mLevel.height())
-          mRacket->setPosition(b2Vec2(racketX, mLevel.height() - .5f));
-        if (racketX < 0.f)
-          mRacket->setPosition(b2Vec2(1.5f, racketY));
-        else if (racketX > mLevel.width())
-          mRacket->setPosition(b2Vec2(mLevel.width() - 1.5f, racketY));
-
+        input.input |= ReplayFrame::ClampRacket;
         const b2AABB &aabb = mRacket->aabb();
         const float32 w = aabb.upperBound.x - aabb.lowerBound.x;
         // const float32 h = aabb.upperBound.y - aabb.lowerBound.y;
@@ -1525,26 +1945,132 @@ namespace Impact {
         sf::Mouse::setPosition(mousePos, mWindow);
       }
 
-      mRacket->moveTo(InvScale * b2Vec2(float32(mousePos.x), float32(mousePos.y)));
+      input.x = int16_t(mousePos.x);
+      input.y = int16_t(mousePos.y);
+    }
+    mProfiler.end(FrameProfiler::EventPolling);
+
+    if (mState != State::Playing) {
+      drawPlayground();
+      return;
+    }
+
+    input.tick = mTick;
+    applyInput(input);
+
+    if (mElapsed > sf::Time::Zero) {
+      const int tickRate = gLocalSettings().physicsTickRate();
+      const sf::Time timeStep = tickRate > 0 ? sf::microseconds(1000000 / tickRate) : mElapsed;
+      int steps = 1;
+      if (tickRate > 0)
+        steps = dueSteps(timeStep);
+      else
+        mInterpolation = 1.f;
+      // frames that neither step the world nor carry events cannot
+      // influence the simulation, so they are left out of the replay
+      if (mReplayRecording && (steps > 0 || (input.input & ReplayFrame::EventMask) != 0)) {
+        input.steps = uint16_t(steps);
+        mReplay.record(input);
+      }
+      if (mSimulationThread.joinable()) {
+        // step the world on the simulation thread while this frame
+        // draws the state published by finishSimulation()
+        startSimulation(steps, timeStep);
+      }
+      else {
+        advance(steps, timeStep, elapsedSeconds);
+      }
+      measureFPS();
+    }
+    drawPlayground();
+  }
+
+
+  void Game::applyInput(const ReplayFrame &input)
+  {
+    if ((input.input & ReplayFrame::NewBall) != 0) {
+      if (mBalls.empty())
+        newBall();
+    }
+    if ((input.input & ReplayFrame::ExtraBall) != 0 && mRacket != nullptr) {
+      const b2Vec2 &racketPos = mRacket->position();
+      newBall(b2Vec2(racketPos.x, racketPos.y - 1.2f * sign(mLevel.gravity())));
+    }
+    if ((input.input & ReplayFrame::RecoverBall) != 0) {
+      if (mBalls.empty()) {
+        newBall();
+      }
+      else if (mRacket != nullptr) {
+        const b2Vec2 &padPos = mRacket->position();
+        for (std::vector<SlotHandle>::const_iterator b = mBalls.cbegin(); b != mBalls.cend(); ++b) {
+          Ball *ball = reinterpret_cast<Ball*>(body(*b));
+          ball->setPosition(b2Vec2(padPos.x, padPos.y - 3.5f));
+          showScore(-DefaultForceNewBallPenalty, ball->position());
+        }
+      }
+    }
+
+    if (mRacket == nullptr)
+      return;
+
+    if ((input.input & ReplayFrame::KickLeft) != 0)
+      mRacket->kickLeft();
+    else if ((input.input & ReplayFrame::KickRight) != 0)
+      mRacket->kickRight();
+    else
+      mRacket->stopKick();
+
+    if ((input.input & ReplayFrame::ClampRacket) != 0) {
+      // check if racket has been kicked out of the screen
+      const float racketX = mRacket->position().x;
+      const float racketY = mRacket->position().y;
+      if (racketY > mLevel.height())
+        mRacket->setPosition(b2Vec2(racketX, mLevel.height() - .5f));
+      if (racketX < 0.f)
+        mRacket->setPosition(b2Vec2(1.5f, racketY));
+      else if (racketX > mLevel.width())
+        mRacket->setPosition(b2Vec2(mLevel.width() - 1.5f, racketY));
     }
 
-    if (mScaleGravityEnabled && mScaleGravityClock.getElapsedTime() > mScaleGravityDuration) {
+    mRacket->moveTo(InvScale * b2Vec2(float32(input.x), float32(input.y)));
+  }
+
+
+  void Game::killBallsOutsidePlayground(void)
+  {
+    for (std::vector<SlotHandle>::const_iterator b = mBalls.cbegin(); b != mBalls.cend(); ++b) {
+      Ball *ball = reinterpret_cast<Ball*>(body(*b));
+      if (ball != nullptr && ball->isActive()) {
+        const float ballX = ball->position().x;
+        const float ballY = ball->position().y;
+        if (0 > ballX || ballX > float(mLevel.width()) || 0 > ballY) {
+          condemn(ball);
+        }
+        else if (ballY > mLevel.height()) {
+          ball->lethalHit();
+          condemn(ball);
+        }
+      }
+    }
+  }
+
+
+  void Game::expireScaleEffects(void)
+  {
+    if (mScaleGravityEnabled && mSimulationTime - mScaleGravityStart > mScaleGravityDuration) {
       mWorld->SetGravity(b2Vec2(0.f, mLevel.gravity()));
       mScaleGravityEnabled = false;
     }
 
-    if (mScaleBallDensityEnabled && mScaleBallDensityClock.getElapsedTime() > mScaleBallDensityDuration) {
-      for (std::vector<Ball*>::iterator b = mBalls.begin(); b != mBalls.end(); ++b) {
-        Ball *ball = *b;
+    if (mScaleBallDensityEnabled && mSimulationTime - mScaleBallDensityStart > mScaleBallDensityDuration) {
+      for (std::vector<SlotHandle>::const_iterator b = mBalls.cbegin(); b != mBalls.cend(); ++b) {
+        Ball *ball = reinterpret_cast<Ball*>(body(*b));
         if (ball != nullptr && ball->isAlive()) {
           ball->setDensity(ball->tileParam().density.get());
         }
       }
       mScaleBallDensityEnabled = false;
     }
-
-    update();
-    drawPlayground();
   }
 
 
@@ -1557,6 +2083,7 @@ namespace Impact {
 
   void Game::onAchievementsScreen(void)
   {
+    TRACE_SCOPE("Game::onAchievementsScreen");
     // TODO: implement onAchievementsScreen()
   }
 
@@ -1576,6 +2103,7 @@ namespace Impact {
 
   void Game::onCreditsScreen(void)
   {
+    TRACE_SCOPE("Game::onCreditsScreen");
     const sf::Vector2f &mousePos = getCursorPosition();
     const float t = mWallClock.getElapsedTime().asSeconds();
 
@@ -1627,11 +2155,10 @@ namespace Impact {
     }
 
     if (mWelcomeLevel == 0) {
-      ExplosionDef pd(this, b2Vec2(.5f * DefaultTilesHorizontally, .4f * DefaultTilesVertically));
+      ExplosionDef pd(b2Vec2(.5f * DefaultTilesHorizontally, .4f * DefaultTilesVertically));
       pd.ballCollisionEnabled = false;
       pd.count = gLocalSettings().particlesPerExplosion();
-      pd.texture = mParticleTexture;
-      addBody(new Explosion(pd));
+      addExplosion(pd);
       mWelcomeLevel = 1;
     }
 
@@ -1655,6 +2182,7 @@ namespace Impact {
 
   void Game::onOptionsScreen(void)
   {
+    TRACE_SCOPE("Game::onOptionsScreen");
     const sf::Vector2f &mousePos = getCursorPosition();
     const float t = mWallClock.getElapsedTime().asSeconds();
 
@@ -1673,11 +2201,10 @@ namespace Impact {
     }
 
     if (mWelcomeLevel == 0) {
-      ExplosionDef pd(this, b2Vec2(.5f * DefaultTilesHorizontally, .4f * DefaultTilesVertically));
+      ExplosionDef pd(b2Vec2(.5f * DefaultTilesHorizontally, .4f * DefaultTilesVertically));
       pd.ballCollisionEnabled = false;
       pd.count = gLocalSettings().particlesPerExplosion();
-      pd.texture = mParticleTexture;
-      addBody(new Explosion(pd));
+      addExplosion(pd);
       mWelcomeLevel = 1;
     }
 
@@ -1746,20 +2273,18 @@ namespace Impact {
           }
           else if (mShadersAvailable && gLocalSettings().useShaders() && (mMenuUseShadersForExplosionsText.getGlobalBounds().contains(mousePos) || useShadersForExplosionsText.getGlobalBounds().contains(mousePos))) {
             gLocalSettings().setUseShadersForExplosions(!gLocalSettings().useShadersForExplosions());
-            ExplosionDef pd(this, InvScale * b2Vec2(mousePos.x, mousePos.y));
+            ExplosionDef pd(InvScale * b2Vec2(mousePos.x, mousePos.y));
             pd.count = gLocalSettings().particlesPerExplosion();
-            pd.texture = mParticleTexture;
-            addBody(new Explosion(pd));
+            addExplosion(pd);
             gLocalSettings().save();
           }
           else if (mMenuParticlesPerExplosionText.getGlobalBounds().contains(mousePos) || particlesPerExplosionText.getGlobalBounds().contains(mousePos)) {
-            gLocalSettings().setParticlesPerExplosion(gLocalSettings().particlesPerExplosion() + 10U);
-            if (gLocalSettings().particlesPerExplosion() > 200U)
+            gLocalSettings().setParticlesPerExplosion(gLocalSettings().particlesPerExplosion() + (gLocalSettings().particlesPerExplosion() < 100U ? 10U : 50U));
+            if (gLocalSettings().particlesPerExplosion() > 500U)
               gLocalSettings().setParticlesPerExplosion(10U);
-            ExplosionDef pd(this, InvScale * b2Vec2(mousePos.x, mousePos.y));
+            ExplosionDef pd(InvScale * b2Vec2(mousePos.x, mousePos.y));
             pd.count = gLocalSettings().particlesPerExplosion();
-            pd.texture = mParticleTexture;
-            addBody(new Explosion(pd));
+            addExplosion(pd);
             gLocalSettings().save();
           }
           else if (mMenuMusicVolumeText.getGlobalBounds().contains(mousePos) || musicVolumeText.getGlobalBounds().contains(mousePos)) {
@@ -1864,6 +2389,7 @@ namespace Impact {
 
   void Game::onSelectLevelScreen(void)
   {
+    TRACE_SCOPE("Game::onSelectLevelScreen");
     const sf::Vector2f &mousePos = getCursorPosition();
     const float t = mWallClock.getElapsedTime().asSeconds();
 
@@ -1954,11 +2480,10 @@ namespace Impact {
     }
 
     if (mWelcomeLevel == 0) {
-      ExplosionDef pd(this, b2Vec2(.5f * DefaultTilesHorizontally, .4f * DefaultTilesVertically));
+      ExplosionDef pd(b2Vec2(.5f * DefaultTilesHorizontally, .4f * DefaultTilesVertically));
       pd.ballCollisionEnabled = false;
       pd.count = gLocalSettings().particlesPerExplosion();
-      pd.texture = mParticleTexture;
-      addBody(new Explosion(pd));
+      addExplosion(pd);
       mWelcomeLevel = 1;
     }
 
@@ -1983,6 +2508,7 @@ namespace Impact {
 
   void Game::onCampaignScreen(void)
   {
+    TRACE_SCOPE("Game::onCampaignScreen");
     const sf::Vector2f &mousePos = getCursorPosition();
 
     mMenuResumeCampaignText.setString(gLocalSettings().lastCampaignLevel() > 1 ? tr("Resume Campaign") : tr("Start Campaign"));
@@ -2056,11 +2582,10 @@ namespace Impact {
     mWindow.draw(mMenuBackText);
 
     if (mWelcomeLevel == 0) {
-      ExplosionDef pd(this, InvScale * b2Vec2(mousePos.x, mousePos.y));
+      ExplosionDef pd(InvScale * b2Vec2(mousePos.x, mousePos.y));
       pd.ballCollisionEnabled = false;
       pd.count = gLocalSettings().particlesPerExplosion();
-      pd.texture = mParticleTexture;
-      addBody(new Explosion(pd));
+      addExplosion(pd);
       mWelcomeLevel = 1;
     }
 
@@ -2071,48 +2596,74 @@ namespace Impact {
   }
 
 
-  inline void Game::executeVignette(sf::RenderTexture &out, sf::RenderTexture &in, bool copyBack)
+  sf::Shader *Game::postEffectShader(unsigned int effects)
   {
-    if (gLocalSettings().useShaders()) {
-      if (mRacket != nullptr && !mBalls.empty()) {
-        mVignetteShader.setParameter("uHSV", mHSVShift);
-        sf::RenderStates states;
-        sf::Sprite sprite(in.getTexture());
-        states.shader = &mVignetteShader;
-        out.draw(sprite, states);
-        if (copyBack)
-          executeCopy(in, out);
-      }
-    }
+    std::string defines;
+    if (effects & VignetteEffect)
+      defines += "#define VIGNETTE\n";
+    if (effects & AberrationEffect)
+      defines += "#define ABERRATION\n";
+    if (effects & EarthquakeEffect)
+      defines += "#define EARTHQUAKE\n";
+    if (effects & MixEffect)
+      defines += "#define MIX\n";
+    return ShaderRegistry::variant(ShadersDir + "/postfx.fs", defines);
   }
 
 
-  inline void Game::executeKeyhole(sf::RenderTexture &out, sf::RenderTexture &in, const b2Vec2 &center, bool copyBack)
+  inline void Game::executePostEffects(sf::RenderTarget &out, const sf::Texture &in, unsigned int effects)
   {
-    if (gLocalSettings().useShaders()) {
-      sf::RenderStates states;
-      sf::Sprite sprite(in.getTexture());
-      states.shader = &mKeyholeShader;
-      const sf::Vector2f &pos = sf::Vector2f(center.x / DefaultTilesHorizontally, center.y / DefaultTilesVertically);
-      mKeyholeShader.setParameter("uCenter", pos);
-      out.draw(sprite, states);
-      if (copyBack)
-        executeCopy(in, out);
+    sf::Shader *shader = mPostEffectShaders[effects];
+    if (shader != nullptr) {
+      if (effects & VignetteEffect) {
+        shader->setParameter("uVignetteStretch", 1.f);
+        shader->setParameter("uHSV", mHSVShift);
+      }
+      if (effects & AberrationEffect) {
+        shader->setParameter("uAberrationT", mAberrationClock.getElapsedTime().asSeconds());
+        shader->setParameter("uAberrationMaxT", mAberrationDuration.asSeconds());
+        shader->setParameter("uAberrationDistort", mAberrationIntensity);
+        shader->setParameter("uAberrationCenter", mAberrationCenter);
+      }
+      if (effects & EarthquakeEffect) {
+        const float32 maxIntensity = mEarthquakeIntensity * InvScale;
+        std::uniform_real_distribution<float32> randomShift(-maxIntensity, maxIntensity);
+        // drawn once per frame, so it must not consume numbers from gRNG(),
+        // which has to stay in step with the simulation for replays
+        static std::mt19937 shakeRNG;
+        shader->setParameter("uEarthquakeT", mEarthquakeClock.getElapsedTime().asSeconds());
+        shader->setParameter("uEarthquakeMaxT", mEarthquakeDuration.asSeconds());
+        shader->setParameter("uRShift", sf::Vector2f(randomShift(shakeRNG), randomShift(shakeRNG)));
+        shader->setParameter("uGShift", sf::Vector2f(randomShift(shakeRNG), randomShift(shakeRNG)));
+        shader->setParameter("uBShift", sf::Vector2f(randomShift(shakeRNG), randomShift(shakeRNG)));
+      }
+      if (effects & MixEffect) {
+        shader->setParameter("uColorMix", mColorMix);
+        shader->setParameter("uColorAdd", mColorAdd);
+        shader->setParameter("uColorSub", mColorSub);
+      }
     }
+    sf::Sprite sprite(in);
+    sf::RenderStates states;
+    states.shader = shader;
+    out.draw(sprite, states);
   }
 
 
-  inline void Game::executeAberration(sf::RenderTexture &out, sf::RenderTexture &in, bool copyBack)
+  inline void Game::executeKeyhole(sf::RenderTexture &out, const sf::Texture &in)
   {
-    if (gLocalSettings().useShaders()) {
-      sf::RenderStates states;
-      sf::Sprite sprite(in.getTexture());
-      states.shader = &mAberrationShader;
-      mAberrationShader.setParameter("uT", mAberrationClock.getElapsedTime().asSeconds());
-      out.draw(sprite, states);
-      if (copyBack)
-        executeCopy(in, out);
+    sf::RenderStates states;
+    sf::Sprite sprite(in);
+    states.shader = &mKeyholeShader;
+    const int n = b2Min(int(mBallPositions.size()), MaxKeyholes);
+    for (int i = 0; i < n; ++i) {
+      const b2Vec2 &center = mBallPositions.at(i);
+      const sf::Vector2f &pos = sf::Vector2f(center.x / DefaultTilesHorizontally, center.y / DefaultTilesVertically);
+      mKeyholeShader.setParameter("uCenter[" + std::to_string(i) + "]", pos);
     }
+    mKeyholeShader.setParameter("uCenterCount", float(n));
+    out.draw(sprite, states);
+    out.display();
   }
 
 
@@ -2128,32 +2679,52 @@ namespace Impact {
       mAberrationDuration += duration;
     }
     mAberrationIntensity += .02f * gravityScale;
-    mAberrationShader.setParameter("uMaxT", mAberrationDuration.asSeconds());
-    mAberrationShader.setParameter("uDistort", mAberrationIntensity);
-    mAberrationShader.setParameter("uCenter", center);
+    mAberrationCenter = center;
   }
 
 
-  inline void Game::executeBlur(sf::RenderTexture &out, sf::RenderTexture &in, bool copyBack)
+  /// Blurs `image` in place with a dual filter: halve the resolution
+  /// BlurLevels times, then double it back up, blurring on the way.
+  inline void Game::executeBlur(sf::RenderTexture &image)
   {
-    UNUSED(copyBack);
-    if (gLocalSettings().useShaders()) {
-      sf::RenderStates states0;
-      states0.shader = &mHBlurShader;
-      sf::Sprite sprite0;
-      sf::RenderStates states1;
-      states1.shader = &mVBlurShader;
-      sf::Sprite sprite1;
-      const float blur = b2Min(1.f, 8.f * mBlurClock.getElapsedTime().asSeconds());
-      for (int i = 3; i < 15; i += 3) {
-        mVBlurShader.setParameter("uBlur", i * blur);
-        mHBlurShader.setParameter("uBlur", i * blur);
-        sprite1.setTexture(in.getTexture());
-        out.draw(sprite1, states1);
-        sprite0.setTexture(out.getTexture());
-        in.draw(sprite0, states0);
+    // the intermediate targets are kept for the next frames
+    if (mBlurTargets[0].getSize().x == 0) {
+      for (int i = 0; i < BlurLevels; ++i) {
+        mBlurTargets[i].create(image.getSize().x >> (i + 1), image.getSize().y >> (i + 1));
+        mBlurTargets[i].setSmooth(true);
+      }
+    }
+    const float offset = 1.5f; //MOD distance of the taps in texels
+    mBlurDownShader.setParameter("uOffset", offset);
+    mBlurUpShader.setParameter("uOffset", offset);
+    sf::RenderStates downStates;
+    downStates.shader = &mBlurDownShader;
+    sf::RenderStates upStates;
+    upStates.shader = &mBlurUpShader;
+
+    const sf::Texture *in = &image.getTexture();
+    for (int i = 0; i < BlurLevels; ++i) {
+      const sf::Vector2u &size = in->getSize();
+      mBlurDownShader.setParameter("uHalfPixel", .5f / size.x, .5f / size.y);
+      sf::Sprite sprite(*in);
+      sprite.setScale(float(mBlurTargets[i].getSize().x) / size.x, float(mBlurTargets[i].getSize().y) / size.y);
+      mBlurTargets[i].draw(sprite, downStates);
+      mBlurTargets[i].display();
+      in = &mBlurTargets[i].getTexture();
+    }
+    for (int i = BlurLevels - 1; i >= 0; --i) {
+      sf::RenderTexture &out = (i > 0) ? mBlurTargets[i - 1] : image;
+      const sf::Vector2u &size = mBlurTargets[i].getSize();
+      mBlurUpShader.setParameter("uHalfPixel", .5f / size.x, .5f / size.y);
+      sf::Sprite sprite(mBlurTargets[i].getTexture());
+      sprite.setScale(float(out.getSize().x) / size.x, float(out.getSize().y) / size.y);
+      if (i == 0) {
+        // fade in by blending over the sharp image, as the blur can't get any smaller than one level
+        const float blur = b2Min(1.f, 8.f * mBlurClock.getElapsedTime().asSeconds());
+        sprite.setColor(sf::Color(255U, 255U, 255U, sf::Uint8(255 * blur)));
       }
-      executeCopy(in, out);
+      out.draw(sprite, upStates);
+      out.display();
     }
   }
 
@@ -2171,25 +2742,6 @@ namespace Impact {
   }
 
 
-  inline void Game::executeEarthquake(sf::RenderTexture &out, sf::RenderTexture &in, bool copyBack)
-  {
-    if (gLocalSettings().useShaders()) {
-      sf::Sprite sprite(in.getTexture());
-      sf::RenderStates states;
-      states.shader = &mEarthquakeShader;
-      const float32 maxIntensity = mEarthquakeIntensity * InvScale;
-      std::uniform_real_distribution<float32> randomShift(-maxIntensity, maxIntensity);
-      mEarthquakeShader.setParameter("uT", mEarthquakeClock.getElapsedTime().asSeconds());
-      mEarthquakeShader.setParameter("uRShift", sf::Vector2f(randomShift(gRNG()), randomShift(gRNG())));
-      mEarthquakeShader.setParameter("uGShift", sf::Vector2f(randomShift(gRNG()), randomShift(gRNG())));
-      mEarthquakeShader.setParameter("uBShift", sf::Vector2f(randomShift(gRNG()), randomShift(gRNG())));
-      out.draw(sprite, states);
-      if (copyBack)
-        executeCopy(in, out);
-    }
-  }
-
-
   void Game::startEarthquake(float32 intensity, const sf::Time &duration)
   {
     if (!gLocalSettings().useShaders())
@@ -2203,7 +2755,6 @@ namespace Impact {
       mEarthquakeIntensity = intensity;
       mEarthquakeClock.restart();
     }
-    mEarthquakeShader.setParameter("uMaxT", mEarthquakeDuration.asSeconds());
     OverlayDef od;
     od.line1 = std::string("Shake ") + std::to_string(int(10 * mEarthquakeIntensity));
     od.line2 = std::string("for ") + std::to_string(mEarthquakeDuration.asMilliseconds() / 1000) + "s";
@@ -2225,6 +2776,8 @@ namespace Impact {
 
   void Game::startOverlay(const OverlayDef &od)
   {
+    if (mHeadless)
+      return;
     mOverlayDuration = od.duration;
     mOverlayText1 = sf::Text(od.line1, mTitleFont, 80U);
     mOverlayText1.setPosition(.5f * (mDefaultView.getSize().x - mOverlayText1.getLocalBounds().width), .16f * (mDefaultView.getSize().y - mOverlayText1.getLocalBounds().height));
@@ -2251,45 +2804,50 @@ namespace Impact {
 
 
 
-  inline void Game::executeCopy(sf::RenderTexture &out, sf::RenderTexture &in)
-  {
-    sf::Sprite sprite(in.getTexture());
-    out.draw(sprite);
-  }
-
-
   void Game::drawPlayground(void)
   {
+    mProfiler.begin(FrameProfiler::DrawPlayground);
     mWindow.setView(mPlaygroundView);
     clearWindow();
 
     if (gLocalSettings().useShaders()) {
-      mRenderTexture0.clear(mLevel.backgroundColor());
-      mRenderTexture0.draw(mLevel.backgroundSprite());
+      drawBodies(mRenderTexture0, true);
+      mRenderTexture0.display();
 
-      for (BodyList::const_iterator b = mBodies.cbegin(); b != mBodies.cend(); ++b) {
-        const Body *body = *b;
-        if (body->isAlive())
-          mRenderTexture0.draw(*body);
-      }
+      // passes ping-pong between the two render textures, `in` always holds the latest image.
+      // Every target is display()ed after drawing into it, so that SFML knows its pixels are
+      // stored upside down and no pass flips the image.
+      sf::RenderTexture *in = &mRenderTexture0;
+      sf::RenderTexture *out = &mRenderTexture1;
 
-      if (mKeyholeEffect && mBalls.size() > 0 && gLocalSettings().useShaders()) {
-        std::vector<Ball*>::const_iterator ball;
-        for (ball = mBalls.cbegin(); ball != mBalls.cend(); ++ball)
-          executeKeyhole(mRenderTexture1, mRenderTexture0, (*ball)->position(), true);
+      if (mKeyholeEffect && mBallPositions.size() > 0) {
+        mProfiler.begin(FrameProfiler::ExecuteKeyhole);
+        executeKeyhole(*out, in->getTexture());
+        std::swap(in, out);
+        mProfiler.end(FrameProfiler::ExecuteKeyhole);
       }
 
-      if (mVignettizePlayground) {
-        executeVignette(mRenderTexture1, mRenderTexture0, true);
-      }
+      unsigned int effects = MixEffect;
+
+      if (mVignettizePlayground && mRacket != nullptr && !mBalls.empty())
+        effects |= VignetteEffect;
 
       if (mBlurPlayground) {
-        executeBlur(mRenderTexture1, mRenderTexture0, true);
+        mProfiler.begin(FrameProfiler::ExecuteBlur);
+        // the vignette belongs underneath the blur, so it can't join the final pass
+        if (effects & VignetteEffect) {
+          executePostEffects(*out, in->getTexture(), VignetteEffect);
+          out->display();
+          std::swap(in, out);
+          effects &= ~VignetteEffect;
+        }
+        executeBlur(*in);
+        mProfiler.end(FrameProfiler::ExecuteBlur);
       }
 
       if (mAberrationDuration > sf::Time::Zero) {
         if (mAberrationClock.getElapsedTime() < mAberrationDuration) {
-          executeAberration(mRenderTexture1, mRenderTexture0, true);
+          effects |= AberrationEffect;
         }
         else {
           mAberrationDuration = sf::Time::Zero;
@@ -2298,7 +2856,7 @@ namespace Impact {
       }
 
       if (mEarthquakeIntensity > 0.f && mEarthquakeClock.getElapsedTime() < mEarthquakeDuration) {
-        executeEarthquake(mRenderTexture1, mRenderTexture0, true);
+        effects |= EarthquakeEffect;
       }
       else {
         if (mEarthquakeClock.getElapsedTime() > mEarthquakeDuration)
@@ -2315,28 +2873,21 @@ namespace Impact {
           mFadeEffectsActive = 0;
         }
         if (mFadeEffectsDarken)
-          mMixShader.setParameter("uColorSub", sf::Color(c, c, c, 0));
+          mColorSub = sf::Color(c, c, c, 0);
         else
-          mMixShader.setParameter("uColorAdd", sf::Color(c, c, c, 0));
+          mColorAdd = sf::Color(c, c, c, 0);
       }
       else {
-        mMixShader.setParameter("uColorSub", sf::Color(0, 0, 0, 0));
-        mMixShader.setParameter("uColorAdd", sf::Color(0, 0, 0, 0));
+        mColorSub = sf::Color(0, 0, 0, 0);
+        mColorAdd = sf::Color(0, 0, 0, 0);
       }
 
-      sf::Sprite sprite(mRenderTexture0.getTexture());
-      sf::RenderStates states;
-      states.shader = &mMixShader;
-      mWindow.draw(sprite, states);
+      mProfiler.begin(FrameProfiler::ExecutePostEffects);
+      executePostEffects(mWindow, in->getTexture(), effects);
+      mProfiler.end(FrameProfiler::ExecutePostEffects);
     }
     else { // !gLocalSettings().useShaders
-      mWindow.clear(mLevel.backgroundColor());
-      mWindow.draw(mLevel.backgroundSprite());
-      for (BodyList::const_iterator b = mBodies.cbegin(); b != mBodies.cend(); ++b) {
-        const Body *body = *b;
-        if (body->isAlive())
-          mWindow.draw(*body);
-      }
+      drawBodies(mWindow, true);
     }
 
     if (mOverlayDuration > sf::Time::Zero) {
@@ -2365,6 +2916,8 @@ namespace Impact {
     mWindow.draw(mFPSText);
     mWindow.draw(mLevelNameText);
     mWindow.draw(mLevelAuthorText);
+    if (mProfilerVisible)
+      mWindow.draw(mProfilerText);
 
     if (mState == State::Playing) {
       mWindow.draw(mScoreMsg);
@@ -2388,7 +2941,7 @@ namespace Impact {
         i->sprite.setPosition(pos);
         i->sprite.setColor(sf::Color(255U, 255U, 255U, alpha));
         mWindow.draw(i->sprite);
-        pos.x -= i->texture.getSize().x;
+        pos.x -= i->sprite.getTextureRect().width;
       }
       else {
         expiredEffects.push_back(i);
@@ -2398,6 +2951,7 @@ namespace Impact {
       mSpecialEffects.erase(*i);
     }
 
+    mProfiler.end(FrameProfiler::DrawPlayground);
   }
 
 
@@ -2414,11 +2968,45 @@ namespace Impact {
         mCurrentScoreMsg.setString("total: " + std::to_string(std::max<int64_t>(0, mTotalScore + mLevelScore - penalty)));
         mCurrentScoreMsg.setPosition(mStatsView.getSize().x - mCurrentScoreMsg.getLocalBounds().width - 4, 20);
       }
+      if (mProfilerVisible) {
+        static const FrameProfiler::Phase phases[] = {
+          FrameProfiler::Frame,
+          FrameProfiler::EventPolling,
+          FrameProfiler::Step,
+          FrameProfiler::EvaluateCollisions,
+          FrameProfiler::UpdateBodies,
+          FrameProfiler::DrawPlayground,
+          FrameProfiler::Display
+        };
+        std::stringstream ss;
+        ss << std::fixed << std::setprecision(2) << std::left << std::setw(20) << "ms" << std::right << std::setw(7) << "p50" << std::setw(7) << "p95" << std::setw(7) << "p99" << std::endl;
+        for (std::size_t i = 0; i < sizeof(phases) / sizeof(phases[0]); ++i) {
+          const FrameProfiler::Phase phase = phases[i];
+          ss << std::left << std::setw(20) << FrameProfiler::PhaseNames[phase] << std::right
+            << std::setw(7) << mProfiler.percentile(phase, 50.f)
+            << std::setw(7) << mProfiler.percentile(phase, 95.f)
+            << std::setw(7) << mProfiler.percentile(phase, 99.f) << std::endl;
+        }
+        mProfilerText.setString(ss.str());
+      }
       mStatsClock.restart();
     }
   }
 
 
+  void Game::exportProfile(void)
+  {
+    boost::system::error_code ec;
+    boost::filesystem::create_directories(gLocalSettings().profilesDir(), ec);
+    const std::string &csvFilename = gLocalSettings().profilesDir() + "/" + mLevel.name() + "-" + timestamp() + ".csv";
+    if (mProfiler.exportCSV(csvFilename)) {
+#ifndef NDEBUG
+      std::cout << "Frame profile saved to " << csvFilename << std::endl;
+#endif
+    }
+  }
+
+
   void Game::drawStartMessage(void)
   {
     mStartMsg.setColor(sf::Color(255U, 255U, 255U, 192U + sf::Uint8(63U * std::sin(14 * mWallClock.getElapsedTime().asSeconds()))));
@@ -2430,97 +3018,251 @@ namespace Impact {
   inline void Game::drawWorld(const sf::View &view)
   {
     mWindow.setView(view);
+    drawBodies(mWindow, false);
+  }
+
+
+  void Game::drawBodies(sf::RenderTarget &target, bool withStaticLayer)
+  {
+    // Everything that can be drawn from the level's texture atlas
+    // without a shader of its own goes into one batch; only the rest
+    // is drawn body by body, on top of it. Bodies that don't move come
+    // from the static layer together with the level background.
+    mBodyBatch.clear();
+    mBodyBatch.setTexture(&mLevel.atlas().texture());
+    mUnbatchedBodies.clear();
+    mStaticBodies.clear();
     for (BodyList::const_iterator b = mBodies.cbegin(); b != mBodies.cend(); ++b) {
       const Body *body = *b;
-      if (body->isAlive()) {
-        mWindow.draw(*body);
-      }
+      if (!body->isAlive())
+        continue;
+      if (withStaticLayer && body->isStatic())
+        mStaticBodies.push_back(body);
+      else if (!body->addTo(mBodyBatch))
+        mUnbatchedBodies.push_back(body);
     }
+    if (withStaticLayer) {
+      // the order of mBodies changes whenever a body is removed, so the
+      // static bodies are compared as a set
+      std::sort(mStaticBodies.begin(), mStaticBodies.end());
+      if (!mStaticLayerValid || mStaticBodies != mStaticLayerBodies)
+        renderStaticLayer();
+      target.draw(sf::Sprite(mStaticLayer.getTexture()));
+    }
+    target.draw(mBodyBatch);
+    for (ConstBodyList::const_iterator b = mUnbatchedBodies.cbegin(); b != mUnbatchedBodies.cend(); ++b)
+      target.draw(**b);
+    target.draw(mParticleSystem);
   }
 
 
-  void Game::evaluateCollisions(void)
+  void Game::renderStaticLayer(void)
   {
-    std::list<Body*> killedBodies;
+    TRACE_SCOPE("Game::renderStaticLayer");
+    if (mStaticLayer.getSize().x == 0)
+      mStaticLayer.create(DefaultPlaygroundWidth, DefaultPlaygroundHeight);
+    mStaticLayer.clear(mLevel.backgroundColor());
+    mStaticLayer.draw(mLevel.backgroundSprite());
+    SpriteBatch batch;
+    batch.setTexture(&mLevel.atlas().texture());
+    ConstBodyList unbatched;
+    for (ConstBodyList::const_iterator b = mStaticBodies.cbegin(); b != mStaticBodies.cend(); ++b)
+      if (!(*b)->addTo(batch))
+        unbatched.push_back(*b);
+    mStaticLayer.draw(batch);
+    for (ConstBodyList::const_iterator b = unbatched.cbegin(); b != unbatched.cend(); ++b)
+      mStaticLayer.draw(**b);
+    mStaticLayer.display();
+    mStaticLayerBodies = mStaticBodies;
+    mStaticLayerValid = true;
+  }
 
-    auto isAlive = [&killedBodies](Body *body) {
-      return std::find(killedBodies.cbegin(), killedBodies.cend(), body) == killedBodies.cend();
-    }; // You find this a somewhat obscure syntax? Google "c++ lambda functions closures" ;-)
 
-    for (int i = 0; i < mContactPointCount; ++i) {
-      ContactPoint &cp = mPoints[i];
+  void Game::registerCollisionHandler(Body::BodyType typeA, Body::BodyType typeB, CollisionHandler handler)
+  {
+    mCollisionDispatch[typeA][typeB].handler = handler;
+    mCollisionDispatch[typeA][typeB].swapped = false;
+    if (typeA != typeB) {
+      mCollisionDispatch[typeB][typeA].handler = handler;
+      mCollisionDispatch[typeB][typeA].swapped = true;
+    }
+  }
+
+
+  void Game::initCollisionHandlers(void)
+  {
+    for (int type = Body::BodyType::Nobody; type < Body::BodyType::LastBodyType; ++type)
+      registerCollisionHandler(Body::BodyType::Bumper, Body::BodyType(type), &Game::onBumperContact);
+    registerCollisionHandler(Body::BodyType::Ball, Body::BodyType::Block, &Game::onBallHitsBlock);
+    registerCollisionHandler(Body::BodyType::Ball, Body::BodyType::Ground, &Game::onBallHitsGround);
+    registerCollisionHandler(Body::BodyType::Ball, Body::BodyType::Racket, &Game::onBallHitsRacket);
+    registerCollisionHandler(Body::BodyType::Block, Body::BodyType::Ground, &Game::onBlockHitsGround);
+    registerCollisionHandler(Body::BodyType::Block, Body::BodyType::Racket, &Game::onBlockHitsRacket);
+  }
+
+
+  void Game::evaluateCollisions(void)
+  {
+    for (std::vector<ContactPoint>::const_iterator c = mContacts.cbegin(); c != mContacts.cend(); ++c) {
+      const ContactPoint &cp = *c;
       Body *a = reinterpret_cast<Body *>(cp.fixtureA->GetUserData());
       Body *b = reinterpret_cast<Body *>(cp.fixtureB->GetUserData());
       if (a == nullptr || b == nullptr)
         continue;
-      if (a->type() == Body::BodyType::Block || b->type() == Body::BodyType::Block) {
-        if (a->type() == Body::BodyType::Ball || b->type() == Body::BodyType::Ball) {
-          Block *block = reinterpret_cast<Block*>(a->type() == Body::BodyType::Block ? a : b);
-          if (isAlive(block)) {
-            bool destroyed = block->hit(cp.normalImpulse);
-            if (destroyed) {
-              block->kill();
-              showScore(block->getScore(), block->position());
-              killedBodies.push_back(block);
-            }
-            else if (cp.normalImpulse > 20)
-              playSound(mBlockHitSound, block->position());
-          }
-        }
-        else if (a->type() == Body::BodyType::Ground || b->type() == Body::BodyType::Ground) {
-          Block *block = reinterpret_cast<Block*>(a->type() == Body::BodyType::Block ? a : b);
-          if (isAlive(block)) {
-            block->kill();
-            killedBodies.push_back(block);
-          }
-        }
-        else if (a->type() == Body::BodyType::Racket || b->type() == Body::BodyType::Racket) {
-          Block *block = reinterpret_cast<Block*>(a->type() == Body::BodyType::Block ? a : b);
-          if (block->body()->GetGravityScale() > 0.f) {
-            if (isAlive(block)) {
-              showScore(block->getScore(), block->position(), 2);
-              block->kill();
-              playSound(mRacketHitBlockSound, block->position());
-              killedBodies.push_back(block);
-            }
-          }
-          else {
-            if (mPenaltyClock.getElapsedTime() > DefaultPenaltyInterval) {
-              showScore(-block->getScore(), block->position());
-              playSound(mPenaltySound, block->position());
-              startFadeEffect();
-              mPenaltyClock.restart();
-            }
-          }
-        }
+      const CollisionDispatch &dispatch = mCollisionDispatch[a->type()][b->type()];
+      if (dispatch.handler == nullptr)
+        continue;
+      if (dispatch.swapped)
+        (this->*dispatch.handler)(b, a, cp);
+      else
+        (this->*dispatch.handler)(a, b, cp);
+    }
+  }
+
+
+  // The handlers run right after each physics step, possibly on the
+  // simulation thread. They only do the physics and leave everything
+  // else to the events they post. A body condemned by an earlier
+  // contact of the same step may still show up in later contacts; it
+  // has left the world already, so the handlers check isActive().
+
+  void Game::onBallHitsBlock(Body *, Body *body, const ContactPoint &cp)
+  {
+    Block *block = reinterpret_cast<Block*>(body);
+    if (!block->isActive())
+      return;
+    bool destroyed = block->hit(cp.normalImpulse);
+    if (destroyed) {
+      condemn(block);
+      postEvent(GameEvent(GameEvent::BlockDestroyed, block->handle()));
+    }
+    else if (cp.normalImpulse > 20)
+      postEvent(GameEvent(GameEvent::Sound, block->handle(), SlotHandle(), &mBlockHitSound));
+  }
+
+
+  void Game::onBallHitsGround(Body *body, Body *, const ContactPoint &)
+  {
+    Ball *ball = reinterpret_cast<Ball*>(body);
+    if (!ball->isActive())
+      return;
+    ball->lethalHit();
+    condemn(ball);
+    postEvent(GameEvent(GameEvent::BallLost, ball->handle()));
+  }
+
+
+  void Game::onBallHitsRacket(Body *ball, Body *, const ContactPoint &cp)
+  {
+    if (cp.normalImpulse > 20)
+      postEvent(GameEvent(GameEvent::Sound, ball->handle(), SlotHandle(), &mRacketHitSound));
+  }
+
+
+  void Game::onBlockHitsGround(Body *block, Body *, const ContactPoint &)
+  {
+    if (block->isActive())
+      condemn(block);
+  }
+
+
+  void Game::onBlockHitsRacket(Body *body, Body *, const ContactPoint &)
+  {
+    Block *block = reinterpret_cast<Block*>(body);
+    if (block->body()->GetGravityScale() > 0.f) {
+      if (block->isActive()) {
+        condemn(block);
+        postEvent(GameEvent(GameEvent::BlockCaught, block->handle(), SlotHandle(), &mRacketHitBlockSound));
       }
-      else if (a->type() == Body::BodyType::Ball || b->type() == Body::BodyType::Ball) {
-        Ball *ball = reinterpret_cast<Ball*>(a->type() == Body::BodyType::Ball ? a : b);
-        if (a->type() == Body::BodyType::Ground || b->type() == Body::BodyType::Ground) {
-          if (isAlive(ball)) {
-            ball->lethalHit();
-            ball->kill();
-            killedBodies.push_back(ball);
-            startFadeEffect(true, sf::milliseconds(350));
-          }
-        }
-        else if (a->type() == Body::BodyType::Racket || b->type() == Body::BodyType::Racket) {
-          if (cp.normalImpulse > 20)
-            playSound(mRacketHitSound, ball->position());
-        }
+    }
+    else {
+      if (mSimulationTime - mLastPenalty > DefaultPenaltyInterval) {
+        postEvent(GameEvent(GameEvent::Penalty, block->handle()));
+        mLastPenalty = mSimulationTime;
       }
-      if (a->type() == Body::BodyType::Bumper || b->type() == Body::BodyType::Bumper) {
-        Bumper *bumper = reinterpret_cast<Bumper*>(a->type() == Body::BodyType::Bumper ? a : b);
-        Body *other = a->type() != Body::BodyType::Bumper ? a : b;
-        playSound(mBumperSound, bumper->position());
-        if (other->type() == Body::BodyType::Ball)
-          addToScore(bumper->getScore());
-        bumper->activate();
-        b2Vec2 impulse = other->position() - bumper->position();
-        impulse.Normalize();
-        other->body()->ApplyLinearImpulse(bumper->tileParam().bumperImpulse * impulse, other->body()->GetPosition(), true);
+    }
+  }
+
+
+  void Game::onBumperContact(Body *body, Body *other, const ContactPoint &)
+  {
+    Bumper *bumper = reinterpret_cast<Bumper*>(body);
+    b2Vec2 impulse = other->position() - bumper->position();
+    impulse.Normalize();
+    other->body()->ApplyLinearImpulse(bumper->tileParam().bumperImpulse * impulse, other->body()->GetPosition(), true);
+    postEvent(GameEvent(GameEvent::BumperHit, bumper->handle(), other->handle()));
+  }
+
+
+  void Game::condemn(Body *body)
+  {
+    // the body stops colliding at once, Body::kill() and everything
+    // hanging off it follow in dispatchEvents()
+    body->body()->SetActive(false);
+    postEvent(GameEvent(GameEvent::Kill, body->handle()));
+  }
+
+
+  void Game::dispatchEvents(void)
+  {
+    // handlers may post further events, which are handled in the same
+    // pass; the buffer keeps its capacity from tick to tick
+    for (std::vector<GameEvent>::size_type i = 0; i < mEvents.size(); ++i) {
+      const GameEvent event = mEvents[i];
+      Body *subject = body(event.body);
+      if (subject == nullptr)
+        continue;
+      switch (event.type) {
+      case GameEvent::Kill:
+        if (subject->isAlive())
+          subject->kill();
+        break;
+      case GameEvent::BodyKilled:
+        onBodyKilled(subject);
+        break;
+      case GameEvent::BlockDestroyed:
+        showScore(reinterpret_cast<Block*>(subject)->getScore(), subject->position());
+        break;
+      case GameEvent::BlockCaught:
+        showScore(reinterpret_cast<Block*>(subject)->getScore(), subject->position(), 2);
+        playSound(*event.sound, subject->position());
+        break;
+      case GameEvent::Sound:
+        playSound(*event.sound, subject->position());
+        break;
+      case GameEvent::BumperHit:
+      {
+        Body *other = body(event.other);
+        if (other != nullptr)
+          onBumperHit(subject, other);
+        break;
+      }
+      case GameEvent::BallLost:
+        startFadeEffect(true, sf::milliseconds(350));
+        break;
+      case GameEvent::Penalty:
+      {
+        const Block *block = reinterpret_cast<Block*>(subject);
+        showScore(-block->getScore(), block->position());
+        playSound(mPenaltySound, block->position());
+        startFadeEffect();
+        break;
+      }
+      default:
+        break;
       }
     }
+    mEvents.clear();
+  }
+
+
+  void Game::onBumperHit(Body *body, Body *other)
+  {
+    Bumper *bumper = reinterpret_cast<Bumper*>(body);
+    playSound(mBumperSound, bumper->position());
+    if (other->type() == Body::BodyType::Ball)
+      addToScore(bumper->getScore());
+    bumper->activate();
   }
 
 
@@ -2531,42 +3273,219 @@ namespace Impact {
 
     const float elapsedSeconds = 1e-6f * mElapsed.asMicroseconds();
 
-    mContactPointCount = 0;
-    mWorld->Step(elapsedSeconds, gLocalSettings().velocityIterations(), gLocalSettings().positionIterations());
+    const int tickRate = gLocalSettings().physicsTickRate();
+    if (tickRate > 0) {
+      // advance the simulation in fixed steps, so that physics cost
+      // per second does not depend on the frame rate, and let the
+      // sprites interpolate between the last two physics states
+      const sf::Time timeStep = sf::microseconds(1000000 / tickRate);
+      advance(dueSteps(timeStep), timeStep, elapsedSeconds);
+    }
+    else {
+      mInterpolation = 1.f;
+      advance(1, mElapsed, elapsedSeconds);
+    }
+
+    measureFPS();
+  }
+
+
+  void Game::measureFPS(void)
+  {
+    mFPSArray[mFPSIndex++] = int(1.f / mElapsed.asSeconds());
+    if (mFPSIndex >= mFPSArray.size())
+      mFPSIndex = 0;
+    mFPS = std::accumulate(mFPSArray.begin(), mFPSArray.end(), 0) / mFPSArray.size();
+  }
+
+
+  int Game::dueSteps(const sf::Time &timeStep)
+  {
+    mPhysicsAccumulator += mElapsed;
+    int steps = 0;
+    while (mPhysicsAccumulator >= timeStep) {
+      if (steps == MaxPhysicsStepsPerFrame) {
+        // drop the backlog instead of spiralling into ever longer frames
+        mPhysicsAccumulator = sf::Time::Zero;
+        break;
+      }
+      mPhysicsAccumulator -= timeStep;
+      ++steps;
+    }
+    mInterpolation = mPhysicsAccumulator / timeStep;
+    return steps;
+  }
+
+
+  void Game::advance(int steps, const sf::Time &timeStep, float elapsedSeconds)
+  {
+    mSimulationTime += sf::Int64(steps) * timeStep;
+    mTick += steps;
+    simulate(steps, timeStep);
+    evaluate(elapsedSeconds);
+  }
+
+
+  void Game::simulate(int steps, const sf::Time &timeStep)
+  {
+    // Runs on the simulation thread if there is one, so it must not touch
+    // anything but the Box2D world, the bodies' physical state and the
+    // contact and event buffers. The main thread doesn't change the
+    // state while the steps run.
+    TRACE_SCOPE("Game::simulate");
+    const bool playing = mState == State::Playing;
+    for (int i = 0; i < steps; ++i) {
+      for (BodyList::const_iterator b = mBodies.cbegin(); b != mBodies.cend(); ++b)
+        if (*b != nullptr && (*b)->isAlive())
+          (*b)->saveTransform();
+      mContacts.clear();
+      stepPhysics(1e-6f * timeStep.asMicroseconds());
+      mergeContacts();
+      if (playing) {
+        // a body killed in this step must not take part in the next one
+        sf::Clock clock;
+        evaluateCollisions();
+        killBallsOutsidePlayground();
+        mCollisionProfile += 1e-3f * clock.getElapsedTime().asMicroseconds();
+      }
+      const b2Profile &profile = mWorld->GetProfile();
+      mStepProfile.step += profile.step;
+      mStepProfile.collide += profile.collide;
+      mStepProfile.solve += profile.solve;
+      mStepProfile.solveTOI += profile.solveTOI;
+      mStepProfile.broadphase += profile.broadphase;
+    }
+    if (playing)
+      expireScaleEffects();
+  }
+
+
+  void Game::evaluate(float elapsedSeconds)
+  {
+    // the step times are collected by simulate(), possibly on the
+    // simulation thread, but only handed over to the profiler here
+    mProfiler.add(FrameProfiler::Step, mStepProfile.step);
+    mProfiler.add(FrameProfiler::StepCollide, mStepProfile.collide);
+    mProfiler.add(FrameProfiler::StepSolve, mStepProfile.solve);
+    mProfiler.add(FrameProfiler::StepSolveTOI, mStepProfile.solveTOI);
+    mProfiler.add(FrameProfiler::StepBroadphase, mStepProfile.broadphase);
+    mStepProfile = b2Profile();
+    mProfiler.add(FrameProfiler::EvaluateCollisions, mCollisionProfile);
+    mCollisionProfile = 0.f;
+
+    // bodies killed since the last dispatch are still in mBodies, they
+    // are reaped only further down
+    dispatchEvents();
+
+    if (mCursorOnRacketRequested) {
+      mCursorOnRacketRequested = false;
+      setCursorOnRacket();
+    }
+
+    mProfiler.begin(FrameProfiler::UpdateBodies);
+    // Dead bodies are destroyed here and nowhere else, so everything
+    // that ran during the tick could safely refer to them.
+    BodyList::size_type i = 0;
+    while (i < mBodies.size()) {
+      Body *body = mBodies[i];
+      if (body->isAlive()) {
+        // the BodyKilled event of an expired body is dispatched
+        // next tick, so the body must stay until then
+        if (body->hasLifetime() && body->overAge())
+          body->kill();
+        ++i;
+      }
+      else {
+        // the last body takes over slot i, so i must not advance
+        mBodies.erase(body->handle());
+        recycle(body);
+      }
+    }
+    // the handles of the bodies just reaped no longer resolve
+    mBalls.erase(std::remove_if(mBalls.begin(), mBalls.end(), [this](const SlotHandle &handle) { return body(handle) == nullptr; }), mBalls.end());
+    // Body::onUpdate() only touches the body itself, so the visual
+    // updates can be spread across the worker threads
+    mWorkers.run(mBodies.size(), MinBodiesPerJob, [this, elapsedSeconds](BodyList::size_type first, BodyList::size_type last) {
+      for (BodyList::size_type i = first; i < last; ++i) {
+        Body *body = mBodies[i];
+        if (body->isAlive())
+          body->update(elapsedSeconds);
+      }
+    });
+    mProfiler.end(FrameProfiler::UpdateBodies);
+
+    // everything the renderer needs from the world besides the sprites
+    mBallPositions.clear();
+    for (std::vector<SlotHandle>::const_iterator b = mBalls.cbegin(); b != mBalls.cend(); ++b)
+      mBallPositions.push_back(body(*b)->position());
+
+    mProfiler.begin(FrameProfiler::UpdateParticles);
+    mParticleSystem.update(mSimulationTime, mWorld->GetGravity(), mBallPositions, mWorkers);
+    mProfiler.end(FrameProfiler::UpdateParticles);
+  }
+
+
+  void Game::stepPhysics(float32 timeStep)
+  {
+    mWorld->Step(timeStep, gLocalSettings().velocityIterations(), gLocalSettings().positionIterations());
     /* Note from the Box2D manual: You should always process the
     * contact points [collected in PostSolve()] immediately after
     * the time step; otherwise some other client code might
     * alter the physics world, invalidating the contact buffer.
+    * simulate() evaluates the contact buffer right after each step.
     */
-    if (mState == State::Playing)
-      evaluateCollisions();
     mWorld->ClearForces();
+  }
 
-    BodyList remainingBodies;
-    for (BodyList::iterator b = mBodies.begin(); b != mBodies.end(); ++b) {
-      Body *body = *b;
-      if (body != nullptr) {
-        if (body->isAlive()) {
-          body->update(elapsedSeconds);
-          remainingBodies.push_back(body);
-        }
-        else {
-          if (body->type() == Body::BodyType::Ball) {
-            const Ball *const ball = reinterpret_cast<Ball*>(body);
-            std::vector<Ball*>::iterator ball2remove = std::find(mBalls.begin(), mBalls.end(), ball);
-            mBalls.erase(ball2remove);
-          }
-          delete body;
-        }
-      }
+
+  void Game::startSimulation(int steps, const sf::Time &timeStep)
+  {
+    mSimulationTime += sf::Int64(steps) * timeStep;
+    mTick += steps;
+    std::unique_lock<std::mutex> lock(mSimulationMutex);
+    mSimulationSteps = steps;
+    mSimulationTimeStep = timeStep;
+    mSimulationBusy = true;
+    mSimulationPending = true;
+    mSimulationCondition.notify_all();
+  }
+
+
+  void Game::waitForSimulation(void)
+  {
+    if (!mSimulationThread.joinable())
+      return;
+    std::unique_lock<std::mutex> lock(mSimulationMutex);
+    mSimulationCondition.wait(lock, [this]{ return !mSimulationBusy; });
+  }
+
+
+  void Game::finishSimulation(float elapsedSeconds)
+  {
+    mProfiler.begin(FrameProfiler::SimulationWait);
+    waitForSimulation();
+    mProfiler.end(FrameProfiler::SimulationWait);
+    if (mSimulationPending) {
+      mSimulationPending = false;
+      evaluate(elapsedSeconds);
     }
-    mBodies = remainingBodies;
+  }
 
 
-    mFPSArray[mFPSIndex++] = int(1.f / mElapsed.asSeconds());
-    if (mFPSIndex >= mFPSArray.size())
-      mFPSIndex = 0;
-    mFPS = std::accumulate(mFPSArray.begin(), mFPSArray.end(), 0) / mFPSArray.size();
+  void Game::simulationThreadProc(void)
+  {
+    Trace::setThreadName("simulation");
+    std::unique_lock<std::mutex> lock(mSimulationMutex);
+    for (;;) {
+      mSimulationCondition.wait(lock, [this]{ return mSimulationBusy || mQuitSimulation; });
+      if (mQuitSimulation)
+        break;
+      lock.unlock();
+      simulate(mSimulationSteps, mSimulationTimeStep);
+      lock.lock();
+      mSimulationBusy = false;
+      mSimulationCondition.notify_all();
+    }
   }
 
 
@@ -2581,14 +3500,14 @@ namespace Impact {
         Racket *racket = reinterpret_cast<Racket*>(a->type() == Body::BodyType::Racket ? a : b);
         if (racket->position().x + racket->aabb().lowerBound.x < 0.f) {
           contact->SetEnabled(false);
-          setCursorOnRacket();
+          mCursorOnRacketRequested = true;
         }
       }
       else if (a->type() == Body::BodyType::RightBoundary || b->type() == Body::BodyType::RightBoundary) {
         Racket *racket = reinterpret_cast<Racket*>(a->type() == Body::BodyType::Racket ? a : b);
         if (racket->position().x + racket->aabb().upperBound.x > DefaultTilesHorizontally) {
           contact->SetEnabled(false);
-          setCursorOnRacket();
+          mCursorOnRacketRequested = true;
         }
       }
     }
@@ -2597,20 +3516,65 @@ namespace Impact {
 
   void Game::PostSolve(b2Contact *contact, const b2ContactImpulse *impulse)
   {
-    if (mContactPointCount < MaxContactPoints) {
-      ContactPoint &cp = mPoints[mContactPointCount];
-      cp.fixtureA = contact->GetFixtureA();
-      cp.fixtureB = contact->GetFixtureB();
-      Body *bodyA = reinterpret_cast<Body*>(cp.fixtureA->GetUserData());
-      Body *bodyB = reinterpret_cast<Body*>(cp.fixtureB->GetUserData());
-      if (bodyA != nullptr && bodyB != nullptr) {
-        b2Manifold *manifold = contact->GetManifold();
-        cp.point = manifold->localPoint;
-        cp.normal = manifold->localNormal;
-        cp.normalImpulse = impulse->normalImpulses[0];
-        ++mContactPointCount;
+    ContactPoint cp;
+    cp.fixtureA = contact->GetFixtureA();
+    cp.fixtureB = contact->GetFixtureB();
+    if (cp.fixtureA->GetUserData() == nullptr || cp.fixtureB->GetUserData() == nullptr)
+      return;
+    const b2Manifold *manifold = contact->GetManifold();
+    cp.point = manifold->localPoint;
+    cp.normal = manifold->localNormal;
+    cp.pointCount = impulse->count;
+    cp.normalImpulse = 0.f;
+    cp.totalNormalImpulse = 0.f;
+    for (int32 i = 0; i < impulse->count; ++i) {
+      cp.normalImpulse = std::max(cp.normalImpulse, impulse->normalImpulses[i]);
+      cp.totalNormalImpulse += impulse->normalImpulses[i];
+    }
+    mContacts.push_back(cp);
+  }
+
+
+  void Game::mergeContacts(void)
+  {
+    // PostSolve() may report a fixture pair more than once per step,
+    // e.g. again in a TOI sub-step. Fold the reports into the first
+    // record of the pair. The order of first appearance is kept,
+    // because the order in which the contacts are evaluated must not
+    // depend on memory addresses, or replays would drift.
+    typedef std::vector<ContactPoint>::size_type size_type;
+    const size_type n = mContacts.size();
+    if (n < 2)
+      return;
+    mContactOrder.resize(n);
+    for (size_type i = 0; i < n; ++i)
+      mContactOrder[i] = i;
+    std::sort(mContactOrder.begin(), mContactOrder.end(), [this](size_type a, size_type b) {
+      const ContactPoint &ca = mContacts[a];
+      const ContactPoint &cb = mContacts[b];
+      if (ca.fixtureA != cb.fixtureA)
+        return ca.fixtureA < cb.fixtureA;
+      if (ca.fixtureB != cb.fixtureB)
+        return ca.fixtureB < cb.fixtureB;
+      return a < b;
+    });
+    ContactPoint *head = &mContacts[mContactOrder[0]];
+    bool merged = false;
+    for (size_type i = 1; i < n; ++i) {
+      ContactPoint &cp = mContacts[mContactOrder[i]];
+      if (cp.fixtureA == head->fixtureA && cp.fixtureB == head->fixtureB) {
+        head->normalImpulse = std::max(head->normalImpulse, cp.normalImpulse);
+        head->totalNormalImpulse += cp.totalNormalImpulse;
+        head->pointCount = std::max(head->pointCount, cp.pointCount);
+        cp.fixtureA = nullptr;
+        merged = true;
+      }
+      else {
+        head = &cp;
       }
     }
+    if (merged)
+      mContacts.erase(std::remove_if(mContacts.begin(), mContacts.end(), [](const ContactPoint &cp) { return cp.fixtureA == nullptr; }), mContacts.end());
   }
 
 
@@ -2626,6 +3590,7 @@ namespace Impact {
 
   void Game::buildLevel(void)
   {
+    TRACE_SCOPE("Game::buildLevel");
     mLastKillings = std::vector<sf::Time>(mLevel.killingsPerKillingSpree(), sf::milliseconds(INT_MIN));
 
     const float32 g = mLevel.gravity();
@@ -2662,6 +3627,17 @@ namespace Impact {
     mGround->setPosition(0, g < 0.f ? 0 : mLevel.height());
     addBody(mGround);
 
+    // explosion particles bounce off the same edges as the balls, or off
+    // the boundary drawn into the level if there is one
+    mParticleSystem.setGrid(mLevel.width(), mLevel.height());
+    const Boundary &boundary = mLevel.boundary();
+    if (boundary.valid)
+      mParticleSystem.setBounds(
+        b2Vec2(float32(boundary.left) / mLevel.tileWidth(), float32(boundary.top) / mLevel.tileHeight()),
+        b2Vec2(float32(boundary.right) / mLevel.tileWidth(), float32(boundary.bottom) / mLevel.tileHeight()));
+    else
+      mParticleSystem.setBounds(b2Vec2(0.f, 0.f), b2Vec2(W, H));
+
 
     if (mLevel.backgroundVisible()) {
       const sf::Texture *bgTex = mLevel.backgroundSprite().getTexture();
@@ -2704,6 +3680,7 @@ namespace Impact {
         if (tileId >= mLevel.firstGID()) {
           if (tileParam.textureName == Ball::Name) {
             mBallTileParam = tileParam;
+            mParticleSystem.setBallRadius(.5f * tileParam.textureSize.x * InvScale);
             newBall(pos);
           }
           else if (tileParam.textureName == Racket::Name) {
@@ -2720,6 +3697,7 @@ namespace Impact {
             Wall *wall = new Wall(tileId, this, tileParam);
             wall->setPosition(pos);
             addBody(wall);
+            mParticleSystem.setSolid(x, y);
           }
           else {
             Block *block = new Block(tileId, this, tileParam);
@@ -2731,6 +3709,9 @@ namespace Impact {
       }
     }
 
+    // the static layer shows the background, which may have changed
+    mStaticLayerValid = false;
+
     mLevelNameText.setString(">> " + mLevel.name() + " <<");
     mLevelNameText.setPosition(4, 52);
     mLevelAuthorText.setString(mLevel.author());
@@ -2750,6 +3731,8 @@ namespace Impact {
 
   void Game::checkHighscore(void)
   {
+    if (mHeadless || mReplayPlayback)
+      return;
     mNewHighscore = gLocalSettings().isHighscore(mLevel.num(), mTotalScore);
     if (mNewHighscore) {
       gLocalSettings().setHighscore(mLevel.num(), mTotalScore);
@@ -2760,6 +3743,8 @@ namespace Impact {
 
   void Game::checkHighscoreForCampaign(void)
   {
+    if (mHeadless)
+      return;
     mNewHighscore = gLocalSettings().isHighscore(mTotalScore);
     if (mNewHighscore) {
       gLocalSettings().setHighscore(mTotalScore);
@@ -2771,10 +3756,11 @@ namespace Impact {
   void Game::showScore(int64_t score, const b2Vec2 &atPos, int factor)
   {
     addToScore(score * factor);
+    if (mHeadless)
+      return;
     const std::string &text = (factor > 1 ? (std::to_string(factor) + "*") : "") + std::to_string(score);
     TextBodyDef td(this, text, mFixedFont, atPos);
-    TextBody *scoreText = new TextBody(td);
-    addBody(scoreText);
+    addBody(mTextBodyPool.acquire(td));
   }
 
 
@@ -2795,7 +3781,7 @@ namespace Impact {
     const int level = mLevel.num();
     const int64_t totalScore = deductPenalty(mLevelScore);
     const int64_t highscore = gLocalSettings().highscore(level);
-    if (totalScore > highscore && highscore != 0) {
+    if (totalScore > highscore && highscore != 0 && !mReplayPlayback) {
       gLocalSettings().setHighscore(level, totalScore);
       if (!mHighscoreReached) {
         playSound(mHighscoreSound);
@@ -2814,7 +3800,7 @@ namespace Impact {
 
   void Game::setCursorOnRacket(void)
   {
-    if (mRacket != nullptr) {
+    if (mRacket != nullptr && !mHeadless && !mReplayPlayback) {
       const b2Vec2 &racketPos = float32(Game::Scale) * mRacket->position();
       sf::Mouse::setPosition(sf::Vector2i(int(racketPos.x), int(racketPos.y)), mWindow);
     }
@@ -2832,8 +3818,8 @@ namespace Impact {
   {
     playSound(mNewBallSound);
     Ball *ball = new Ball(this, mBallTileParam);
-    mBalls.push_back(ball);
     addBody(ball);
+    mBalls.push_back(ball->handle());
     if (mBallHasBeenLost) {
       const b2Vec2 &racketPos = mRacket->position();
       ball->setPosition(b2Vec2(racketPos.x, racketPos.y - 1.2f * sign(mLevel.gravity())));
@@ -2870,7 +3856,33 @@ namespace Impact {
 
   inline void Game::addBody(Body *body)
   {
-    mBodies.push_back(body);
+    body->setHandle(mBodies.insert(body));
+  }
+
+
+  Body *Game::body(const SlotHandle &handle)
+  {
+    Body **body = mBodies.get(handle);
+    return body != nullptr ? *body : nullptr;
+  }
+
+
+  void Game::addExplosion(const ExplosionDef &def)
+  {
+    mParticleSystem.emit(def);
+  }
+
+
+  void Game::recycle(Body *body)
+  {
+    switch (body->type()) {
+    case Body::BodyType::Text:
+      mTextBodyPool.release(reinterpret_cast<TextBody*>(body));
+      break;
+    default:
+      delete body;
+      break;
+    }
   }
 
 
@@ -2914,6 +3926,8 @@ namespace Impact {
 
   void Game::playSound(const sf::SoundBuffer &buffer, const b2Vec2 &pos)
   {
+    if (mHeadless)
+      return;
     sf::Sound &sound = mSoundFX[mSoundIndex];
     sound.setBuffer(buffer);
     sound.setPosition(pos.x, 0, 0);
@@ -2925,6 +3939,8 @@ namespace Impact {
 
   void Game::playMusic(Game::Music music, bool loop)
   {
+    if (mHeadless)
+      return;
     stopAllMusic();
     mMusic[music].play();
     mMusic[music].setLoop(loop);
@@ -2947,14 +3963,13 @@ namespace Impact {
   {
     if (killedBody->type() == Body::BodyType::Block) {
       playSound(mExplosionSound, killedBody->position());
-      ExplosionDef pd(this, killedBody->position());
+      ExplosionDef pd(killedBody->position());
       pd.ballCollisionEnabled = mLevel.explosionParticlesCollideWithBall();
       pd.count = gLocalSettings().particlesPerExplosion();
-      pd.texture = mParticleTexture;
-      addBody(new Explosion(pd));
+      addExplosion(pd);
       {
         // check for killing spree
-        mLastKillings[mLastKillingsIndex] = mWallClock.getElapsedTime();
+        mLastKillings[mLastKillingsIndex] = mSimulationTime;
         int i = (mLastKillingsIndex - mLastKillings.size()) % int(mLastKillings.size());
         const sf::Time &dt = mLastKillings.at(mLastKillingsIndex) - mLastKillings.at(i);
         mLastKillingsIndex = (mLastKillingsIndex + 1) % mLastKillings.size();
@@ -2976,6 +3991,7 @@ namespace Impact {
         mWorld->SetGravity(tileParam.scaleGravityBy * mWorld->GetGravity());
         mScaleGravityEnabled = true;
         mScaleGravityClock.restart();
+        mScaleGravityStart = mSimulationTime;
         mScaleGravityDuration = tileParam.scaleGravityDuration;
         startAberrationEffect(tileParam.scaleGravityBy, tileParam.scaleGravityDuration);
         OverlayDef od;
@@ -2985,12 +4001,12 @@ namespace Impact {
         addSpecialEffect(SpecialEffect(mScaleGravityDuration, &mScaleGravityClock, killedBody->texture()));
       }
       if (tileParam.scaleBallDensityDuration > sf::Time::Zero) {
-        for (std::vector<Ball*>::iterator b = mBalls.begin(); b != mBalls.end(); ++b) {
-          Ball *ball = *b;
+        for (std::vector<SlotHandle>::const_iterator b = mBalls.cbegin(); b != mBalls.cend(); ++b) {
+          Ball *ball = reinterpret_cast<Ball*>(body(*b));
           ball->setDensity(tileParam.scaleBallDensityBy * ball->tileParam().density.get());
         }
         mScaleBallDensityEnabled = true;
-        mScaleBallDensityClock.restart();
+        mScaleBallDensityStart = mSimulationTime;
         mScaleBallDensityDuration = tileParam.scaleBallDensityDuration;
       }
       if (tileParam.multiball) {
@@ -3017,12 +4033,15 @@ namespace Impact {
   void Game::enumerateAllLevels(void)
   {
     std::packaged_task<bool()> task([this]{
+      Trace::setThreadName("level enumeration");
+      TRACE_SCOPE("Game::enumerateAllLevels");
 #if defined(WIN32)
       const int prio = GetThreadPriority(GetCurrentThread());
       SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_LOWEST);
 #endif
       if (mLevels.empty()) {
         for (int l = 1; !mQuitEnumeration; ++l) {
+          TRACE_SCOPE("enumerate level");
           Level level(l);
           if (!level.isAvailable())
             break;
@@ -33,30 +33,44 @@
 #include "Racket.h"
 #include "Ground.h"
 #include "ScrollArea.h"
+#include "Replay.h"
+#include "FrameProfiler.h"
+#include "Benchmark.h"
+#include "BodyPool.h"
+#include "ParticleSystem.h"
+#include "WorkerPool.h"
+#include "SpriteBatch.h"
 
 #ifndef NO_RECORDER
 #include "Recorder.h"
 #endif
 
 #include <future>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
 
 
 
 namespace Impact {
 
   class Game;
+  class TextBody;
+  class TextBodyDef;
 
   struct SpecialEffect {
     SpecialEffect(void)
       : clock(nullptr)
     { /* ... */ }
-    SpecialEffect(const sf::Time &d, sf::Clock *clk, const sf::Texture &tex)
+    SpecialEffect(const sf::Time &d, sf::Clock *clk, const std::shared_ptr<sf::Texture> &tex)
       : duration(d)
       , clock(clk)
       , texture(tex)
     {
-      sprite.setTexture(texture);
-      sprite.setOrigin(float(texture.getSize().x), float(texture.getSize().y));
+      if (texture) {
+        sprite.setTexture(*texture);
+        sprite.setOrigin(float(texture->getSize().x), float(texture->getSize().y));
+      }
     }
     SpecialEffect(const SpecialEffect &other)
       : SpecialEffect(other.duration, other.clock, other.texture)
@@ -67,19 +81,53 @@ namespace Impact {
     }
     sf::Time duration;
     sf::Sprite sprite;
-    sf::Texture texture;
+    std::shared_ptr<sf::Texture> texture;
     sf::Clock *clock;
   };
 
+  /// all PostSolve() reports of one fixture pair within one step
   struct ContactPoint {
     b2Fixture *fixtureA;
     b2Fixture *fixtureB;
     b2Vec2 normal;
-    float32 normalImpulse;
+    float32 normalImpulse; // maximum over all reports and manifold points
+    float32 totalNormalImpulse;
+    int32 pointCount;
     b2Vec2 point;
   };
 
 
+  /// Something that happened during a tick and is handled by
+  /// Game::dispatchEvents() once the tick has been evaluated. Events
+  /// are posted from inside the physics steps, possibly on the
+  /// simulation thread, and carry everything that must happen on the
+  /// main thread. The bodies are referred to by handle, so an event
+  /// outliving its bodies resolves to nullptr instead of a dangling
+  /// pointer.
+  struct GameEvent {
+    typedef enum _Type {
+      Kill, // the body has already left the physics world, see Game::condemn()
+      BodyKilled,
+      BlockDestroyed,
+      BlockCaught,
+      Sound,
+      BumperHit,
+      BallLost,
+      Penalty
+    } Type;
+    GameEvent(Type type, const SlotHandle &body, const SlotHandle &other = SlotHandle(), const sf::SoundBuffer *sound = nullptr)
+      : type(type)
+      , body(body)
+      , other(other)
+      , sound(sound)
+    { /* ... */ }
+    Type type;
+    SlotHandle body;
+    SlotHandle other;
+    const sf::SoundBuffer *sound;
+  };
+
+
   struct OverlayDef {
     OverlayDef(void)
       : duration(sf::milliseconds(1000))
@@ -145,6 +193,14 @@ namespace Impact {
       LastMusic
     } Music;
 
+    /// per-pixel effects fused into one pass, see resources/shaders/postfx.fs
+    typedef enum _PostEffect {
+      VignetteEffect = 1 << 0,
+      AberrationEffect = 1 << 1,
+      EarthquakeEffect = 1 << 2,
+      MixEffect = 1 << 3
+    } PostEffect;
+
 #ifndef NDEBUG
     static const char* StateNames[State::LastState];
 #endif
@@ -164,12 +220,20 @@ namespace Impact {
     static const unsigned int DefaultWindowHeight = DefaultPlaygroundHeight + DefaultStatsHeight;
     static const unsigned int ColorDepth = 32U;
     static const unsigned int DefaultFramerateLimit = 0U;
+    static const int TargetFramerate = 60; //MOD frame rate the particle budget aims for when the frame rate is not limited
     static const unsigned int DefaultLives;
     static const int64_t NewLifeAfterSoManyPointsDefault;
     static const int64_t NewLifeAfterSoManyPoints[];
     static const int MaxSoundFX = 16;
     static const int DefaultForceNewBallPenalty;
-    static const int32 MaxContactPoints = 512;
+    static const std::vector<ContactPoint>::size_type InitialContactCapacity = 512;
+    static const std::vector<GameEvent>::size_type InitialEventCapacity = 512;
+    static const BodyList::size_type MinBodiesPerJob = 128;
+    static const int MaxKeyholes = 8; //MOD balls lighting up the playground in keyhole levels, must match MAX_CENTERS in keyhole.fs
+    static const int BlurLevels = 3; //MOD each level halves the resolution and roughly doubles the blur radius
+    static const unsigned int PostEffectVariants = MixEffect << 1;
+    static const int MaxPhysicsStepsPerFrame;
+    static const unsigned int DefaultHeadlessTicks;
     static const sf::Time DefaultFadeEffectDuration;
     static const sf::Time DefaultAberrationEffectDuration;
     static const sf::Time DefaultEarthquakeDuration;
@@ -180,11 +244,17 @@ namespace Impact {
     static const sf::Time DefaultKillingSpreeInterval;
     static const float DefaultWallRestitution;
 
-    Game(void);
+    Game(bool headless = false);
     ~Game();
     void setLevelZip(const char *zipFilename);
     void loop(void);
+    bool runHeadless(const std::string &zipFilename, unsigned int maxTicks = DefaultHeadlessTicks);
+    bool runHeadlessReplay(const std::string &replayFilename);
+    bool runBenchmark(const std::string &outputFilename, const std::string &baselineFilename, unsigned int ticks = Benchmark::DefaultTicks);
+    bool playReplay(const std::string &replayFilename);
     void addBody(Body *body);
+    Body *body(const SlotHandle &);
+    void addExplosion(const ExplosionDef &);
     void initSounds(void);
     void initShaderDependants(void);
     void clearEventQueue(void);
@@ -208,10 +278,31 @@ namespace Impact {
       return mGround;
     }
 
-  public: // slots
-    void onBodyKilled(Body *body);
+    inline float32 interpolation(void) const
+    {
+      return mInterpolation;
+    }
+
+    inline bool isHeadless(void) const
+    {
+      return mHeadless;
+    }
+
+    inline const sf::Time &simulationTime(void) const
+    {
+      return mSimulationTime;
+    }
+
+    // Called by the simulation thread while the main thread waits or
+    // draws, and by the main thread only while no steps are running,
+    // so the queue needs no lock of its own.
+    inline void postEvent(const GameEvent &event)
+    {
+      mEvents.push_back(event);
+    }
 
   private:
+    bool mHeadless;
     unsigned int mNumProcessors;
 #if defined(WIN32)
     HANDLE mMyProcessHandle;
@@ -241,18 +332,21 @@ namespace Impact {
     sf::VertexArray mStatsViewRectangle;
     sf::RenderTexture mRenderTexture0;
     sf::RenderTexture mRenderTexture1;
-    sf::Shader mMixShader;
+    sf::Color mColorMix;
+    sf::Color mColorAdd;
+    sf::Color mColorSub;
     int mFadeEffectsActive;
     bool mFadeEffectsDarken;
     sf::Time mFadeEffectDuration;
-    sf::Shader mHBlurShader;
-    sf::Shader mVBlurShader;
+    sf::Shader *mPostEffectShaders[PostEffectVariants];
+    sf::Shader mBlurDownShader;
+    sf::Shader mBlurUpShader;
+    sf::RenderTexture mBlurTargets[BlurLevels];
     bool mBlurPlayground;
     sf::Shader mKeyholeShader;
     bool mKeyholeEffect;
     bool mVignettizePlayground;
     sf::Vector3f mHSVShift;
-    sf::Shader mVignetteShader;
     sf::Font mFixedFont;
     sf::Font mTitleFont;
     bool mCursorVisible;
@@ -301,28 +395,33 @@ namespace Impact {
     sf::Clock mOverlayClock;
     std::vector<OverlayDef> mOverlayQueue;
     sf::Texture mParticleTexture;
+    sf::Shader mParticleShader;
     std::string mFadeShaderCode;
-    sf::Shader mEarthquakeShader;
     float32 mEarthquakeIntensity;
     sf::Clock mEarthquakeClock;
     sf::Time mEarthquakeDuration;
-    sf::Shader mAberrationShader;
     sf::Clock mAberrationClock;
     sf::Time mAberrationDuration;
     float32 mAberrationIntensity;
+    sf::Vector2f mAberrationCenter;
     ScrollArea mLevelsScrollArea;
     sf::Vector2f mLastMousePos;
     bool mMouseButtonDown;
     sf::Time mElapsed;
+    sf::Time mPhysicsAccumulator;
+    float32 mInterpolation;
+    sf::Time mSimulationTime;
+    uint32_t mTick;
     sf::Clock mClock;
     sf::Clock mWallClock;
     sf::Clock mScoreClock;
     sf::Clock mBlurClock;
     sf::Clock mFadeEffectTimer;
     sf::Clock mScaleGravityClock;
+    sf::Time mScaleGravityStart;
     sf::Time mScaleGravityDuration;
     bool mScaleGravityEnabled;
-    sf::Clock mScaleBallDensityClock;
+    sf::Time mScaleBallDensityStart;
     sf::Time mScaleBallDensityDuration;
     bool mScaleBallDensityEnabled;
     bool mNewHighscore;
@@ -358,12 +457,33 @@ namespace Impact {
     std::vector<int> mFPSArray;
     std::vector<int>::size_type mFPSIndex;
     int mFPS;
+    FrameProfiler mProfiler;
+    bool mProfilerVisible;
+    sf::Text mProfilerText;
 
     // Box2D
     b2World *mWorld;
     Ground *mGround;
-    ContactPoint mPoints[MaxContactPoints];
-    int32 mContactPointCount;
+    std::vector<ContactPoint> mContacts;
+    std::vector<GameEvent> mEvents;
+    std::vector<std::vector<ContactPoint>::size_type> mContactOrder;
+    void mergeContacts(void);
+    b2Profile mStepProfile;
+    float mCollisionProfile;
+
+    // collision handlers indexed by the body types of both fixtures;
+    // swapped tells that the handler expects the bodies the other way round
+    typedef void (Game::*CollisionHandler)(Body *, Body *, const ContactPoint &);
+    struct CollisionDispatch {
+      CollisionDispatch(void)
+        : handler(nullptr)
+        , swapped(false)
+      { /* ... */ }
+      CollisionHandler handler;
+      bool swapped;
+    };
+    CollisionDispatch mCollisionDispatch[Body::BodyType::LastBodyType][Body::BodyType::LastBodyType];
+    void registerCollisionHandler(Body::BodyType, Body::BodyType, CollisionHandler);
 
     // b2ContactListener interface
     virtual void PreSolve(b2Contact* contact, const b2Manifold* oldManifold);
@@ -379,22 +499,56 @@ namespace Impact {
     int64_t mTotalScore;
     unsigned int mLives;
     BodyList mBodies;
+    SpriteBatch mBodyBatch;
+    ConstBodyList mUnbatchedBodies;
+    ConstBodyList mStaticBodies;
+    ConstBodyList mStaticLayerBodies;
+    sf::RenderTexture mStaticLayer;
+    bool mStaticLayerValid;
+    BodyPool<TextBody, TextBodyDef> mTextBodyPool;
+    ParticleSystem mParticleSystem;
+    WorkerPool mWorkers;
     int mBlockCount;
     int mWelcomeLevel;
     int mExtraLifeIndex;
     bool mBallHasBeenLost;
-    std::vector<Ball*> mBalls;
+    std::vector<SlotHandle> mBalls;
     Racket *mRacket;
     Level mLevel;
     TileParam mBallTileParam;
     Timer mLevelTimer;
     sf::Clock mStatsClock;
-    sf::Clock mPenaltyClock;
+    sf::Time mLastPenalty;
     std::vector<sf::Time> mLastKillings;
     int mLastKillingsIndex;
     std::vector<SpecialEffect> mSpecialEffects;
     bool mHighscoreReached;
 
+    std::vector<b2Vec2> mBallPositions;
+    bool mCursorOnRacketRequested;
+
+    // simulation thread
+    std::thread mSimulationThread;
+    std::mutex mSimulationMutex;
+    std::condition_variable mSimulationCondition;
+    int mSimulationSteps;
+    sf::Time mSimulationTimeStep;
+    bool mSimulationBusy;
+    bool mSimulationPending;
+    bool mQuitSimulation;
+    void simulationThreadProc(void);
+    void startSimulation(int steps, const sf::Time &timeStep);
+    void waitForSimulation(void);
+    void finishSimulation(float elapsedSeconds);
+
+    Replay mReplay;
+    bool mReplayRecording;
+    bool mReplayPlayback;
+    bool loadReplay(const std::string &replayFilename);
+    void startReplayRecording(void);
+    void finishReplayRecording(void);
+    void stopReplayPlayback(void);
+    void playbackReplay(void);
     std::string mLevelZipFilename;
     int mDisplayCount;
 
@@ -428,7 +582,14 @@ namespace Impact {
     void clearWorld(void);
     void clearWindow(void);
     void updateStats(void);
+    void exportProfile(void);
+    void dispatchEvents(void);
+    void onBodyKilled(Body *body);
+    void onBumperHit(Body *bumper, Body *other);
+    void recycle(Body *body);
     void drawWorld(const sf::View &view);
+    void drawBodies(sf::RenderTarget &target, bool withStaticLayer);
+    void renderStaticLayer(void);
     void drawStartMessage(void);
     void drawPlayground(void);
     void resumeAllMusic(void);
@@ -440,7 +601,27 @@ namespace Impact {
     void resume(void);
     void buildLevel(void);
     void update(void);
+    void measureFPS(void);
+    int dueSteps(const sf::Time &timeStep);
+    void advance(int steps, const sf::Time &timeStep, float elapsedSeconds);
+    void simulate(int steps, const sf::Time &timeStep);
+    void evaluate(float elapsedSeconds);
+    void applyInput(const ReplayFrame &);
+    void killBallsOutsidePlayground(void);
+    void expireScaleEffects(void);
+    void stepPhysics(float32 timeStep);
+    void condemn(Body *body);
+    bool startHeadlessLevel(void);
+    void printHeadlessReport(unsigned int ticks);
+    bool benchmarkLevel(const std::string &zipFilename, unsigned int ticks, BenchmarkResult &);
     void evaluateCollisions(void);
+    void initCollisionHandlers(void);
+    void onBallHitsBlock(Body *ball, Body *block, const ContactPoint &);
+    void onBallHitsGround(Body *ball, Body *ground, const ContactPoint &);
+    void onBallHitsRacket(Body *ball, Body *racket, const ContactPoint &);
+    void onBlockHitsGround(Body *block, Body *ground, const ContactPoint &);
+    void onBlockHitsRacket(Body *block, Body *racket, const ContactPoint &);
+    void onBumperContact(Body *bumper, Body *other, const ContactPoint &);
     void showCursor(void);
     void hideCursor(void);
     void drawCursor(void);
@@ -451,12 +632,10 @@ namespace Impact {
     void startFadeEffect(bool darken = false, const sf::Time &duration = DefaultFadeEffectDuration);
     void startAberrationEffect(float32 gravityScale, const sf::Time &duration = DefaultAberrationEffectDuration, const sf::Vector2f &pos = sf::Vector2f(.5f, .5f));
     void setKillingsPerKillingSpree(int);
-    void executeCopy(sf::RenderTexture &out, sf::RenderTexture &in);
-    void executeAberration(sf::RenderTexture &out, sf::RenderTexture &in, bool copyBack);
-    void executeBlur(sf::RenderTexture &out, sf::RenderTexture &in, bool copyBack);
-    void executeEarthquake(sf::RenderTexture &out, sf::RenderTexture &in, bool copyBack);
-    void executeKeyhole(sf::RenderTexture &out, sf::RenderTexture &in, const b2Vec2 &center, bool copyBack);
-    void executeVignette(sf::RenderTexture &out, sf::RenderTexture &in, bool copyBack);
+    void executeBlur(sf::RenderTexture &image);
+    void executeKeyhole(sf::RenderTexture &out, const sf::Texture &in);
+    void executePostEffects(sf::RenderTarget &out, const sf::Texture &in, unsigned int effects);
+    sf::Shader *postEffectShader(unsigned int effects);
     void resetKillingSpree(void);
 
     void gotoWelcomeScreen(void);
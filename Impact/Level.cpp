@@ -61,6 +61,7 @@ namespace Impact {
     , mKillingSpreeBonus(Game::DefaultKillingSpreeBonus)
     , mKillingSpreeInterval(Game::DefaultKillingSpreeInterval)
     , mSuccessfullyLoaded(false)
+    , mHeadless(false)
     , mMusic(nullptr)
   {
     // ...
@@ -90,6 +91,8 @@ namespace Impact {
     , mKillingSpreeBonus(other.mKillingSpreeBonus)
     , mKillingSpreeInterval(other.mKillingSpreeInterval)
     , mSuccessfullyLoaded(other.mSuccessfullyLoaded)
+    , mHeadless(other.mHeadless)
+    , mZipFilename(other.mZipFilename)
     , mName(other.mName)
     , mCredits(other.mCredits)
     , mAuthor(other.mAuthor)
@@ -161,6 +164,7 @@ namespace Impact {
 #pragma warning(disable : 4503)
   void Level::loadZip(const std::string &zipFilename)
   {
+    TRACE_SCOPE("Level::loadZip");
     mSuccessfullyLoaded = false;
     bool ok = true;
 
@@ -169,6 +173,7 @@ namespace Impact {
 
     safeDelete(mMusic);
 
+    mZipFilename = zipFilename;
     boost::filesystem::path p(zipFilename);
     mName = p.filename().replace_extension().generic_string();
 
@@ -176,6 +181,7 @@ namespace Impact {
     std::cout << "LEVEL NAME: " << mName << std::endl;
 #endif
 
+    TraceScope unzipScope("unzip");
 #if defined(WIN32)
     HZIP hz = OpenZip(zipFilename.c_str(), nullptr);
     if (hz) {
@@ -191,7 +197,7 @@ namespace Impact {
         if (boost::algorithm::ends_with(currentItemName, ".tmx")) {
           levelFilename = levelPath + "/" + currentItemName;
         }
-        else if (boost::algorithm::ends_with(currentItemName, ".ogg")) {
+        else if (boost::algorithm::ends_with(currentItemName, ".ogg") && !mHeadless) {
           mMusic = new sf::Music;
           if (mMusic != nullptr) {
             bool musicLoaded = mMusic->openFromFile(levelPath + "/" + currentItemName);
@@ -229,7 +235,7 @@ namespace Impact {
         if (boost::algorithm::ends_with(currentItemName, ".tmx")) {
           levelFilename = levelPath + "/" + currentItemName;
         }
-        else if (boost::algorithm::ends_with(currentItemName, ".ogg")) {
+        else if (boost::algorithm::ends_with(currentItemName, ".ogg") && !mHeadless) {
           mMusic = new sf::Music;
           if (mMusic != nullptr) {
             bool musicLoaded = mMusic->openFromFile(levelPath + "/" + currentItemName);
@@ -247,7 +253,12 @@ namespace Impact {
       unzClose(hz);
     }
 #endif
-    calcSHA1(zipFilename);
+    unzipScope.end();
+
+    {
+      TRACE_SCOPE("SHA1");
+      calcSHA1(zipFilename);
+    }
 
     ok = fileExists(levelFilename);
     if (!ok)
@@ -256,6 +267,7 @@ namespace Impact {
     mBackgroundImageOpacity = 1.f;
     boost::property_tree::ptree pt;
     try {
+      TRACE_SCOPE("XML");
       boost::property_tree::xml_parser::read_xml(levelFilename, pt);
     }
     catch (const boost::property_tree::xml_parser::xml_parser_error &ex) {
@@ -341,8 +353,12 @@ namespace Impact {
 
       uint8_t *compressed = nullptr;
       uLong compressedSize = 0UL;
-      base64_decode(mapDataB64, compressed, compressedSize);
+      {
+        TRACE_SCOPE("base64");
+        base64_decode(mapDataB64, compressed, compressedSize);
+      }
       if (compressed != nullptr && compressedSize > 0) {
+        TRACE_SCOPE("inflate");
         static const size_t CHUNKSIZE = 128 * 1024; // sizeof(uint32_t) * Game::DefaultPlaygroundWidth * Game::DefaultPlaygroundHeight;
         uint32_t *mapData = new uint32_t[CHUNKSIZE / sizeof(uint32_t)];
         if (mapData != nullptr) {
@@ -374,7 +390,8 @@ namespace Impact {
 
       try {
         mBackgroundVisible = pt.get<bool>("map.layer.imagelayer.<xmlattr>.visible", true);
-        if (mBackgroundVisible) {
+        if (mBackgroundVisible && !mHeadless) {
+          TRACE_SCOPE("background texture");
           const std::string &backgroundTextureFilename = levelPath + "/" + pt.get<std::string>("map.imagelayer.image.<xmlattr>.source");
           mBackgroundTexture.loadFromFile(backgroundTextureFilename);
           mBackgroundSprite.setTexture(mBackgroundTexture);
@@ -397,6 +414,9 @@ namespace Impact {
       const boost::property_tree::ptree &tileset = pt.get_child("map.tileset");
       mFirstGID = tileset.get<uint32_t>("<xmlattr>.firstgid");
       mTiles.resize(tileset.count("tile") + mFirstGID);
+      mAtlas.clear();
+      mPaddedTextures.clear();
+      std::map<int, sf::Image> images;
       boost::property_tree::ptree::const_iterator ti;
       for (ti = tileset.begin(); ti != tileset.end(); ++ti) {
         boost::property_tree::ptree tile = ti->second;
@@ -405,7 +425,16 @@ namespace Impact {
           mTiles.resize(id + 1);
           TileParam tileParam;
           const std::string &filename = levelPath + "/" + tile.get<std::string>("image.<xmlattr>.source");
-          ok = tileParam.texture.loadFromFile(filename);
+          sf::Image image;
+          ok = image.loadFromFile(filename);
+          tileParam.textureSize = image.getSize();
+          tileParam.texture = std::make_shared<sf::Texture>();
+          // without a GL context only the image dimensions are of interest
+          if (ok && !mHeadless) {
+            TRACE_SCOPE("texture");
+            ok = tileParam.texture->loadFromImage(image);
+            images[id] = image;
+          }
           if (!ok)
             return;
           const boost::property_tree::ptree &tileProperties = tile.get_child("properties");
@@ -489,9 +518,32 @@ namespace Impact {
           }
           if (!tileParam.fixed.isValid())
             tileParam.fixed = (tileParam.textureName == Wall::Name) || (tileParam.textureName == Bumper::Name);
+          // walls have never been drawn filtered, whatever their smooth property says
+          const bool isWall = tileParam.fixed.get() && tileParam.textureName != Bumper::Name;
+          const bool smooth = tileParam.smooth && !isWall;
+          tileParam.texture->setSmooth(smooth);
+          // the atlas is filtered, so unfiltered tiles draw from their own texture;
+          // balls never draw from the atlas
+          if (smooth && tileParam.textureName != Ball::Name && images.count(id) > 0)
+            mAtlas.add(id, images[id]);
           mTiles[id] = tileParam;
         }
       }
+      // bodies whose tile didn't make it into the atlas draw from
+      // their own textures, so a failure here is not fatal
+      if (!mHeadless) {
+        mAtlas.build();
+        // the ball and blocks missing from the atlas need a transparent
+        // margin around their texture for the blur shaders to bleed into
+        std::map<int, sf::Image>::const_iterator i;
+        for (i = images.begin(); i != images.end(); ++i) {
+          const TileParam &tileParam = mTiles.at(i->first);
+          if (tileParam.textureName == Ball::Name)
+            addPaddedTexture(i->first, i->second, Ball::TextureMargin, tileParam.smooth);
+          else if (!tileParam.fixed.get() && !mAtlas.contains(i->first))
+            addPaddedTexture(i->first, i->second, Block::TextureMargin, tileParam.smooth);
+        }
+      }
     }
     catch (boost::property_tree::ptree_error &e) {
       std::cerr << "Error parsing TMX file: " << e.what() << std::endl;
@@ -519,6 +571,19 @@ namespace Impact {
   void Level::clear(void)
   {
     mTiles.clear();
+    mAtlas.clear();
+    mPaddedTextures.clear();
+  }
+
+
+  void Level::addPaddedTexture(int index, const sf::Image &image, int margin, bool smooth)
+  {
+    sf::Image padded;
+    padded.create(image.getSize().x + 2 * margin, image.getSize().y + 2 * margin, sf::Color(0, 0, 0, 0));
+    padded.copy(image, margin, margin, sf::IntRect(0, 0, 0, 0), true);
+    sf::Texture &texture = mPaddedTextures[index];
+    texture.loadFromImage(padded);
+    texture.setSmooth(smooth);
   }
 
 
@@ -537,7 +602,22 @@ namespace Impact {
     const int index = bodyIndexByTextureName(name);
     if (index < 0)
       throw "Bad texture name: '" + name + "'";
-    return mTiles.at(index).texture;
+    return *mTiles.at(index).texture;
+  }
+
+
+  const sf::Vector2u &Level::textureSize(const std::string &name) const
+  {
+    const int index = bodyIndexByTextureName(name);
+    if (index < 0)
+      throw "Bad texture name: '" + name + "'";
+    return mTiles.at(index).textureSize;
+  }
+
+
+  void Level::setHeadless(bool headless)
+  {
+    mHeadless = headless;
   }
 
 
@@ -552,4 +632,11 @@ namespace Impact {
     return mTiles.at(index);
   }
 
+
+  const sf::Texture *Level::paddedTexture(int index) const
+  {
+    std::map<int, sf::Texture>::const_iterator t = mPaddedTextures.find(index);
+    return (t != mPaddedTextures.end()) ? &t->second : nullptr;
+  }
+
 }
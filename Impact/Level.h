@@ -22,10 +22,12 @@
 
 #include <SFML/System.hpp>
 #include <vector>
+#include <map>
 #include <string>
 #include "Body.h"
 #include "globals.h"
 #include "TileParam.h"
+#include "TextureAtlas.h"
 
 #ifdef WIN32
 #include "../zip-utils/unzip.h"
@@ -71,9 +73,11 @@ namespace Impact {
     bool gotoNext(void);
 
     const sf::Texture &texture(const std::string &name) const;
+    const sf::Vector2u &textureSize(const std::string &name) const;
     int bodyIndexByTextureName(const std::string &name) const;
     uint32_t *const mapDataScanLine(int y);
     const TileParam &tileParam(int index) const;
+    const sf::Texture *paddedTexture(int index) const;
     inline bool isAvailable(void) const
     {
       return mSuccessfullyLoaded;
@@ -124,6 +128,10 @@ namespace Impact {
     inline b2Vec2 size(void) const {
       return b2Vec2(float32(mNumTilesX), float32(mNumTilesY));
     }
+    inline const TextureAtlas &atlas(void) const
+    {
+      return mAtlas;
+    }
     inline const Boundary &boundary(void) const
     {
       return mBoundary;
@@ -176,6 +184,10 @@ namespace Impact {
     {
       return mSHA1;
     }
+    inline const std::string &zipFilename(void) const
+    {
+      return mZipFilename;
+    }
     inline sf::Music *music(void)
     {
       return mMusic;
@@ -188,9 +200,17 @@ namespace Impact {
     void load(void);
     void loadZip(const std::string &zipFilename);
 
+    void setHeadless(bool);
+    inline bool isHeadless(void) const
+    {
+      return mHeadless;
+    }
+
   private:
     bool mSuccessfullyLoaded;
+    bool mHeadless;
     std::string mSHA1;
+    std::string mZipFilename;
     float32 mBackgroundImageOpacity;
     bool mBackgroundVisible;
     sf::Color mBackgroundColor;
@@ -219,6 +239,10 @@ namespace Impact {
     sf::Music *mMusic;
 
     std::vector<TileParam> mTiles;
+    TextureAtlas mAtlas;
+    std::map<int, sf::Texture> mPaddedTextures;
+
+    void addPaddedTexture(int index, const sf::Image &image, int margin, bool smooth);
 
     bool calcSHA1(const std::string &filename);
   };
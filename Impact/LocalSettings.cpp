@@ -49,6 +49,9 @@ namespace Impact {
       , framerateLimit(0)
       , velocityIterations(32)
       , positionIterations(64)
+      , physicsTickRate(120)
+      , recordReplays(false)
+      , simulationThread(true)
     { /* ... */ }
     bool useShaders;
     bool useShadersForExplosions;
@@ -61,12 +64,17 @@ namespace Impact {
     unsigned int framerateLimit;
     int velocityIterations;
     int positionIterations;
+    int physicsTickRate;
+    bool recordReplays;
+    bool simulationThread;
 
     std::string appData;
     std::string settingsFile;
     std::string levelsDir;
     std::string soundFXDir;
     std::string musicDir;
+    std::string replaysDir;
+    std::string profilesDir;
 
     std::map<int, int64_t> highscores;
   };
@@ -88,6 +96,8 @@ namespace Impact {
       d->levelsDir = d->appData + "\\levels";
       d->soundFXDir = d->appData + "\\soundfx";
       d->musicDir = d->appData + "\\music";
+      d->replaysDir = d->appData + "\\replays";
+      d->profilesDir = d->appData + "\\profiles";
       load();
     }
 #elif defined(LINUX_AMD64)
@@ -102,6 +112,8 @@ namespace Impact {
     d->levelsDir = d->appData + "/levels";
     d->soundFXDir = d->appData + "/soundfx";
     d->musicDir = d->appData + "/music";
+    d->replaysDir = d->appData + "/replays";
+    d->profilesDir = d->appData + "/profiles";
 #ifndef NDEBUG
     std::cout << "settingsFile = '" << d->settingsFile << "'" << std::endl;
 #endif
@@ -145,6 +157,9 @@ namespace Impact {
       d->velocityIterations = pt.get<unsigned int>("impact.velocity-iterations", 16);
       d->positionIterations = pt.get<unsigned int>("impact.position-iterations", 64);
       d->framerateLimit = pt.get<unsigned int>("impact.frame-rate-limit", 0U);
+      d->physicsTickRate = pt.get<int>("impact.physics-tick-rate", 120);
+      d->recordReplays = pt.get<bool>("impact.record-replays", false);
+      d->simulationThread = pt.get<bool>("impact.simulation-thread", true);
       d->lastOpenDir = pt.get<std::string>("impact.last-open-dir", d->levelsDir);
       d->lastCampaignLevel = pt.get<int>("impact.campaign-last-level", 1);
       if (d->lastCampaignLevel < 1)
@@ -198,6 +213,9 @@ namespace Impact {
     ar & boost::serialization::make_nvp("frame-rate-limit", d->framerateLimit);
     ar & boost::serialization::make_nvp("velocity-iterations", d->velocityIterations);
     ar & boost::serialization::make_nvp("position-iterations", d->positionIterations);
+    ar & boost::serialization::make_nvp("physics-tick-rate", d->physicsTickRate);
+    ar & boost::serialization::make_nvp("record-replays", d->recordReplays);
+    ar & boost::serialization::make_nvp("simulation-thread", d->simulationThread);
     ar & boost::serialization::make_nvp("last-open-dir", d->lastOpenDir);
     ar & boost::serialization::make_nvp("campaign-last-level", d->lastCampaignLevel);
     ar & boost::serialization::make_nvp("campaign-highscore", d->campaignHighscore);
@@ -260,6 +278,18 @@ namespace Impact {
   }
 
 
+  const std::string &LocalSettings::replaysDir(void) const
+  {
+    return d->replaysDir;
+  }
+
+
+  const std::string &LocalSettings::profilesDir(void) const
+  {
+    return d->profilesDir;
+  }
+
+
   void LocalSettings::setMusicVolume(float volume)
   {
     d->musicVolume = volume;
@@ -332,6 +362,42 @@ namespace Impact {
   }
 
 
+  void LocalSettings::setPhysicsTickRate(int hz)
+  {
+    d->physicsTickRate = hz;
+  }
+
+
+  int LocalSettings::physicsTickRate(void) const
+  {
+    return d->physicsTickRate;
+  }
+
+
+  void LocalSettings::setRecordReplays(bool enabled)
+  {
+    d->recordReplays = enabled;
+  }
+
+
+  bool LocalSettings::recordReplays(void) const
+  {
+    return d->recordReplays;
+  }
+
+
+  void LocalSettings::setSimulationThread(bool enabled)
+  {
+    d->simulationThread = enabled;
+  }
+
+
+  bool LocalSettings::simulationThread(void) const
+  {
+    return d->simulationThread;
+  }
+
+
   void LocalSettings::setVelocityIterations(int n)
   {
     d->velocityIterations = n;
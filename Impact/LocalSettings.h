@@ -45,6 +45,8 @@ namespace Impact {
     const std::string &levelsDir(void) const;
     const std::string &musicDir(void) const;
     const std::string &soundFXDir(void) const;
+    const std::string &replaysDir(void) const;
+    const std::string &profilesDir(void) const;
     void setMusicVolume(float);
     float musicVolume(void) const;
     void setSoundFXVolume(float);
@@ -59,6 +61,12 @@ namespace Impact {
     int positionIterations(void) const;
     void setVelocityIterations(int);
     int velocityIterations(void) const;
+    void setPhysicsTickRate(int);
+    int physicsTickRate(void) const;
+    void setRecordReplays(bool);
+    bool recordReplays(void) const;
+    void setSimulationThread(bool);
+    bool simulationThread(void) const;
 
     void setHighscore(int level, int64_t score);
     int64_t highscore(int level) const;
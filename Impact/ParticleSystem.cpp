@@ -0,0 +1,410 @@
+/*
+
+    Copyright (c) 2015 Oliver Lau <ola@ct.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+
+#include "stdafx.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define PARTICLES_SSE2
+#include <emmintrin.h>
+#endif
+
+
+namespace Impact {
+
+  const float32 ParticleSystem::MaxSubStep = 1.f / 240.f; // keeps particles from tunneling through a single tile
+  const std::size_t ParticleSystem::DefaultMaxParticles = 4000; //MOD
+  const float32 ParticleSystem::MinDetail = .1f; //MOD
+  const std::size_t ParticleSystem::MinChunk = 512; // particles per worker job
+
+
+  ExplosionDef::ExplosionDef(const b2Vec2 &pos)
+    : pos(pos)
+    , ballCollisionEnabled(false)
+    , count(50)
+    , minLifetime(sf::milliseconds(500))
+    , maxLifetime(sf::milliseconds(1000))
+    , minSpeed(2.f * Game::Scale)
+    , maxSpeed(5.f * Game::Scale)
+    , gravityScale(5.f)
+    , linearDamping(.2f)
+    , restitution(.8f)
+  { /* ... */ }
+
+
+  ParticleSystem::ParticleSystem(void)
+    : mCount(0)
+    , mGridWidth(0)
+    , mGridHeight(0)
+    , mBounded(false)
+    , mBallRadius(0.f)
+    , mMaxParticles(DefaultMaxParticles)
+    , mDetail(1.f)
+    , mFrameTime(0.f)
+    , mTexture(nullptr)
+    , mVertices(sf::Quads)
+    , mUseShader(false)
+    , mShader(nullptr)
+  { /* ... */ }
+
+
+  ParticleSystem::~ParticleSystem()
+  { /* ... */ }
+
+
+  void ParticleSystem::clear(void)
+  {
+    mCount = 0;
+    mVertices.clear();
+    mGridWidth = 0;
+    mGridHeight = 0;
+    mSolid.clear();
+    mBounded = false;
+  }
+
+
+  void ParticleSystem::setGrid(int width, int height)
+  {
+    mGridWidth = width;
+    mGridHeight = height;
+    mSolid.assign(std::size_t(width * height), 0);
+  }
+
+
+  void ParticleSystem::setSolid(int x, int y)
+  {
+    if (x >= 0 && x < mGridWidth && y >= 0 && y < mGridHeight)
+      mSolid[y * mGridWidth + x] = 1;
+  }
+
+
+  void ParticleSystem::setBounds(const b2Vec2 &lo, const b2Vec2 &hi)
+  {
+    mLo = lo;
+    mHi = hi;
+    mBounded = true;
+  }
+
+
+  void ParticleSystem::setBallRadius(float32 radius)
+  {
+    mBallRadius = radius;
+  }
+
+
+  void ParticleSystem::setTexture(const sf::Texture *texture)
+  {
+    mTexture = texture;
+  }
+
+
+  void ParticleSystem::setShader(const sf::Shader *shader)
+  {
+    mShader = shader;
+  }
+
+
+  void ParticleSystem::setMaxParticles(std::size_t n)
+  {
+    mMaxParticles = n;
+    if (mCount > mMaxParticles)
+      retireOldest(mCount - mMaxParticles);
+  }
+
+
+  void ParticleSystem::setFrameTime(const sf::Time &frameTime, const sf::Time &targetFrameTime)
+  {
+    // follow a smoothed frame time, so that a single slow frame (e.g.
+    // loading a level) doesn't thin out the explosions; back off fast,
+    // recover slowly
+    const float32 t = frameTime.asSeconds();
+    const float32 target = targetFrameTime.asSeconds();
+    mFrameTime = (mFrameTime > 0.f) ? .9f * mFrameTime + .1f * t : t;
+    if (mFrameTime > 1.1f * target)
+      mDetail = std::max(MinDetail, .95f * mDetail);
+    else if (mFrameTime < .9f * target)
+      mDetail = std::min(1.f, mDetail + .01f);
+  }
+
+
+  void ParticleSystem::reserve(std::size_t n)
+  {
+    if (mX.size() >= n)
+      return;
+    mX.resize(n, 0.f);
+    mY.resize(n, 0.f);
+    mVX.resize(n, 0.f);
+    mVY.resize(n, 0.f);
+    mAge.resize(n, 0.f);
+    mLifetime.resize(n, 0.f);
+    mGravityScale.resize(n, 0.f);
+    mDamping.resize(n, 0.f);
+    mRestitution.resize(n, 0.f);
+    mBallCollision.resize(n, 0);
+  }
+
+
+  void ParticleSystem::emit(const ExplosionDef &def)
+  {
+    TRACE_SCOPE("ParticleSystem::emit");
+    std::uniform_int_distribution<sf::Int32> randomLifetime(def.minLifetime.asMilliseconds(), def.maxLifetime.asMilliseconds());
+    std::uniform_real_distribution<float32> randomSpeed(def.minSpeed, def.maxSpeed);
+    std::uniform_real_distribution<float32> randomOffset(-1.f, +1.f);
+
+    // under load explosions get fewer particles, which also die sooner
+    const std::size_t count = std::max<std::size_t>(1, std::size_t(mDetail * def.count + .5f));
+    const float32 lifetimeScale = 1e-3f * (.5f + .5f * mDetail);
+
+    const std::size_t first = mCount;
+    mCount += count;
+    reserve(mCount);
+    for (std::size_t i = first; i < mCount; ++i) {
+      mLifetime[i] = lifetimeScale * randomLifetime(mRNG);
+      mX[i] = def.pos.x + Game::InvScale * randomOffset(mRNG);
+      mY[i] = def.pos.y + Game::InvScale * randomOffset(mRNG);
+      const float32 speed = randomSpeed(mRNG);
+      mVX[i] = speed * randomOffset(mRNG);
+      mVY[i] = speed * randomOffset(mRNG);
+      mAge[i] = 0.f;
+      mGravityScale[i] = def.gravityScale;
+      mDamping[i] = def.linearDamping;
+      mRestitution[i] = def.restitution;
+      mBallCollision[i] = def.ballCollisionEnabled ? 1 : 0;
+    }
+
+    if (mCount > mMaxParticles)
+      retireOldest(mCount - mMaxParticles);
+  }
+
+
+  void ParticleSystem::update(const sf::Time &now, const b2Vec2 &gravity, const std::vector<b2Vec2> &balls, WorkerPool &workers)
+  {
+    // particles age in simulation time like bodies do; when the
+    // simulation clock has been reset, the particles just pause
+    const float32 dt = (now - mLastUpdate).asSeconds();
+    mLastUpdate = now;
+    if (mCount > 0 && dt > 0.f) {
+      // particles don't interact with each other, so each job can run
+      // all sub-steps for its range of particles on its own
+      const int steps = int(std::ceil(dt / MaxSubStep));
+      const float32 h = dt / steps;
+      workers.run(mCount, MinChunk, [this, steps, h, &gravity, &balls](std::size_t first, std::size_t last) {
+        for (int i = 0; i < steps; ++i) {
+          integrate(first, last, h, gravity);
+          collide(first, last, h, balls);
+        }
+      });
+      reap();
+    }
+
+    // one textured quad per particle, so that all explosions together
+    // take a single draw call; the fade of each particle goes into the
+    // vertex colors, which is all the shader needs to know about it, so
+    // it is shared by any number of explosions without ever being rebound
+    mUseShader = mShader != nullptr && gLocalSettings().useShaders() && gLocalSettings().useShadersForExplosions();
+    mVertices.resize(4 * mCount);
+    if (mTexture != nullptr)
+      workers.run(mCount, MinChunk, [this](std::size_t first, std::size_t last) {
+        buildVertices(first, last);
+      });
+  }
+
+
+  void ParticleSystem::integrate(std::size_t first, std::size_t last, float32 h, const b2Vec2 &gravity)
+  {
+    // same integration scheme as b2Island::Solve() for a body without
+    // forces, so particles move like the Box2D bodies they replace
+    std::size_t i = first;
+#ifdef PARTICLES_SSE2
+    const __m128 one = _mm_set1_ps(1.f);
+    const __m128 hh = _mm_set1_ps(h);
+    const __m128 gx = _mm_set1_ps(h * gravity.x);
+    const __m128 gy = _mm_set1_ps(h * gravity.y);
+    for (; i + 4 <= last; i += 4) {
+      const __m128 gs = _mm_loadu_ps(&mGravityScale[i]);
+      const __m128 damping = _mm_div_ps(one, _mm_add_ps(one, _mm_mul_ps(hh, _mm_loadu_ps(&mDamping[i]))));
+      const __m128 vx = _mm_mul_ps(_mm_add_ps(_mm_loadu_ps(&mVX[i]), _mm_mul_ps(gx, gs)), damping);
+      const __m128 vy = _mm_mul_ps(_mm_add_ps(_mm_loadu_ps(&mVY[i]), _mm_mul_ps(gy, gs)), damping);
+      _mm_storeu_ps(&mVX[i], vx);
+      _mm_storeu_ps(&mVY[i], vy);
+      _mm_storeu_ps(&mX[i], _mm_add_ps(_mm_loadu_ps(&mX[i]), _mm_mul_ps(hh, vx)));
+      _mm_storeu_ps(&mY[i], _mm_add_ps(_mm_loadu_ps(&mY[i]), _mm_mul_ps(hh, vy)));
+      _mm_storeu_ps(&mAge[i], _mm_add_ps(_mm_loadu_ps(&mAge[i]), hh));
+    }
+#endif
+    // whatever doesn't fill a whole SSE register
+    for (; i < last; ++i) {
+      const float32 damping = 1.f / (1.f + h * mDamping[i]);
+      mVX[i] = (mVX[i] + h * gravity.x * mGravityScale[i]) * damping;
+      mVY[i] = (mVY[i] + h * gravity.y * mGravityScale[i]) * damping;
+      mX[i] += h * mVX[i];
+      mY[i] += h * mVY[i];
+      mAge[i] += h;
+    }
+  }
+
+
+  void ParticleSystem::collide(std::size_t first, std::size_t last, float32 h, const std::vector<b2Vec2> &balls)
+  {
+    const float32 r2 = mBallRadius * mBallRadius;
+    for (std::size_t i = first; i < last; ++i) {
+      float32 x = mX[i];
+      float32 y = mY[i];
+      float32 vx = mVX[i];
+      float32 vy = mVY[i];
+      const float32 e = mRestitution[i];
+
+      // bounce off the tile the particle has just entered, on the axis
+      // along which it entered
+      if (!mSolid.empty() && isSolid(x, y)) {
+        const float32 ox = x - h * vx;
+        const float32 oy = y - h * vy;
+        const bool blockedX = isSolid(x, oy);
+        const bool blockedY = isSolid(ox, y);
+        if (blockedX || !blockedY) {
+          x = ox;
+          vx = -e * vx;
+        }
+        if (blockedY || !blockedX) {
+          y = oy;
+          vy = -e * vy;
+        }
+      }
+
+      if (mBounded) {
+        if (x < mLo.x) {
+          x = mLo.x;
+          vx = -e * vx;
+        }
+        else if (x > mHi.x) {
+          x = mHi.x;
+          vx = -e * vx;
+        }
+        if (y < mLo.y) {
+          y = mLo.y;
+          vy = -e * vy;
+        }
+        else if (y > mHi.y) {
+          y = mHi.y;
+          vy = -e * vy;
+        }
+      }
+
+      // the balls push particles out, but particles never push back
+      if (mBallCollision[i] != 0) {
+        for (std::vector<b2Vec2>::const_iterator ball = balls.cbegin(); ball != balls.cend(); ++ball) {
+          const float32 dx = x - ball->x;
+          const float32 dy = y - ball->y;
+          const float32 d2 = dx * dx + dy * dy;
+          if (d2 >= r2 || d2 <= 0.f)
+            continue;
+          const float32 d = std::sqrt(d2);
+          const float32 nx = dx / d;
+          const float32 ny = dy / d;
+          x = ball->x + nx * mBallRadius;
+          y = ball->y + ny * mBallRadius;
+          const float32 vn = vx * nx + vy * ny;
+          if (vn < 0.f) {
+            vx -= (1.f + e) * vn * nx;
+            vy -= (1.f + e) * vn * ny;
+          }
+        }
+      }
+
+      mX[i] = x;
+      mY[i] = y;
+      mVX[i] = vx;
+      mVY[i] = vy;
+    }
+  }
+
+
+  void ParticleSystem::reap(void)
+  {
+    // the last particle takes over the slot of a dead one
+    std::size_t i = 0;
+    while (i < mCount) {
+      if (mAge[i] < mLifetime[i]) {
+        ++i;
+        continue;
+      }
+      const std::size_t last = --mCount;
+      mX[i] = mX[last];
+      mY[i] = mY[last];
+      mVX[i] = mVX[last];
+      mVY[i] = mVY[last];
+      mAge[i] = mAge[last];
+      mLifetime[i] = mLifetime[last];
+      mGravityScale[i] = mGravityScale[last];
+      mDamping[i] = mDamping[last];
+      mRestitution[i] = mRestitution[last];
+      mBallCollision[i] = mBallCollision[last];
+    }
+  }
+
+
+  void ParticleSystem::retireOldest(std::size_t n)
+  {
+    // the oldest particles have faded the most, so they are the first
+    // to go when the budget is exceeded
+    mOrder.resize(mCount);
+    for (std::size_t i = 0; i < mCount; ++i)
+      mOrder[i] = i;
+    std::nth_element(mOrder.begin(), mOrder.begin() + n, mOrder.end(), [this](std::size_t a, std::size_t b) {
+      return mAge[a] > mAge[b];
+    });
+    for (std::size_t i = 0; i < n; ++i)
+      mLifetime[mOrder[i]] = 0.f;
+    reap();
+  }
+
+
+  void ParticleSystem::buildVertices(std::size_t first, std::size_t last)
+  {
+    const float tw = float(mTexture->getSize().x);
+    const float th = float(mTexture->getSize().y);
+    const float hw = .5f * tw;
+    const float hh = .5f * th;
+    for (std::size_t i = first; i < last; ++i) {
+      const float x = float(Game::Scale) * mX[i];
+      const float y = float(Game::Scale) * mY[i];
+      const sf::Uint8 alpha = mUseShader
+        ? sf::Uint8(255.f * (1.f - mAge[i] / mLifetime[i]))
+        : sf::Uint8(255.f - Easing<float>::quadEaseIn(mAge[i], 0.f, 255.f, mLifetime[i]));
+      const sf::Color color(255U, 255U, 255U, alpha);
+      sf::Vertex *quad = &mVertices[4 * i];
+      quad[0] = sf::Vertex(sf::Vector2f(x - hw, y - hh), color, sf::Vector2f(0.f, 0.f));
+      quad[1] = sf::Vertex(sf::Vector2f(x + hw, y - hh), color, sf::Vector2f(tw, 0.f));
+      quad[2] = sf::Vertex(sf::Vector2f(x + hw, y + hh), color, sf::Vector2f(tw, th));
+      quad[3] = sf::Vertex(sf::Vector2f(x - hw, y + hh), color, sf::Vector2f(0.f, th));
+    }
+  }
+
+
+  void ParticleSystem::draw(sf::RenderTarget &target, sf::RenderStates states) const
+  {
+    if (mVertices.getVertexCount() == 0 || mTexture == nullptr)
+      return;
+    if (mUseShader)
+      states.shader = mShader;
+    states.texture = mTexture;
+    target.draw(mVertices, states);
+  }
+
+}
@@ -0,0 +1,152 @@
+/*
+
+    Copyright (c) 2015 Oliver Lau <ola@ct.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#ifndef __PARTICLESYSTEM_H_
+#define __PARTICLESYSTEM_H_
+
+#include <Box2D/Box2D.h>
+
+#include <SFML/System.hpp>
+#include <SFML/Graphics.hpp>
+
+#include <vector>
+#include <random>
+#include <cstdint>
+
+namespace Impact {
+
+  class WorkerPool;
+
+  struct ExplosionDef
+  {
+    ExplosionDef(const b2Vec2 &pos);
+    b2Vec2 pos;
+    bool ballCollisionEnabled;
+    unsigned int count;
+    sf::Time minLifetime;
+    sf::Time maxLifetime;
+    float32 minSpeed;
+    float32 maxSpeed;
+    float32 gravityScale;
+    float32 linearDamping;
+    float32 restitution;
+  };
+
+
+  /// Explosion particles live here instead of in the Box2D world.
+  /// The particle state is kept as a structure of arrays so that the
+  /// integration can run four particles at a time. Particles only
+  /// collide with the static tiles of the level, the level bounds and,
+  /// if requested, the balls; they never act back on the world.
+  ///
+  /// The number of live particles is capped, and when frames take
+  /// longer than they should, explosions get fewer and shorter-lived
+  /// particles. As particles don't influence the game, they draw their
+  /// random numbers from a generator of their own so that none of this
+  /// can make a replay diverge.
+  class ParticleSystem : public sf::Drawable
+  {
+  public:
+    ParticleSystem(void);
+    virtual ~ParticleSystem();
+
+    static const float32 MaxSubStep;
+    static const std::size_t DefaultMaxParticles;
+    static const float32 MinDetail;
+    static const std::size_t MinChunk;
+
+    void emit(const ExplosionDef &);
+    void update(const sf::Time &now, const b2Vec2 &gravity, const std::vector<b2Vec2> &balls, WorkerPool &workers);
+    void clear(void);
+
+    void setGrid(int width, int height);
+    void setSolid(int x, int y);
+    void setBounds(const b2Vec2 &lo, const b2Vec2 &hi);
+    void setBallRadius(float32 radius);
+    void setTexture(const sf::Texture *texture);
+    void setShader(const sf::Shader *shader);
+    void setMaxParticles(std::size_t n);
+    void setFrameTime(const sf::Time &frameTime, const sf::Time &targetFrameTime);
+
+    inline std::size_t size(void) const
+    {
+      return mCount;
+    }
+    /// fraction of the requested particles an explosion currently gets
+    inline float32 detail(void) const
+    {
+      return mDetail;
+    }
+
+  private:
+    virtual void draw(sf::RenderTarget &target, sf::RenderStates states) const;
+
+    void reserve(std::size_t n);
+    void integrate(std::size_t first, std::size_t last, float32 h, const b2Vec2 &gravity);
+    void collide(std::size_t first, std::size_t last, float32 h, const std::vector<b2Vec2> &balls);
+    void reap(void);
+    void retireOldest(std::size_t n);
+    void buildVertices(std::size_t first, std::size_t last);
+    inline bool isSolid(float32 x, float32 y) const
+    {
+      // tile (x, y) covers [x, x+1] x [y, y+1], see Body::setPosition()
+      const int col = int(std::floor(x));
+      const int row = int(std::floor(y));
+      return col >= 0 && col < mGridWidth && row >= 0 && row < mGridHeight && mSolid[row * mGridWidth + col] != 0;
+    }
+
+    // particle state, one entry per particle in each array
+    std::size_t mCount;
+    std::vector<float32> mX;
+    std::vector<float32> mY;
+    std::vector<float32> mVX;
+    std::vector<float32> mVY;
+    std::vector<float32> mAge;
+    std::vector<float32> mLifetime;
+    std::vector<float32> mGravityScale;
+    std::vector<float32> mDamping;
+    std::vector<float32> mRestitution;
+    std::vector<uint8_t> mBallCollision;
+
+    // static collision geometry
+    int mGridWidth;
+    int mGridHeight;
+    std::vector<uint8_t> mSolid;
+    bool mBounded;
+    b2Vec2 mLo;
+    b2Vec2 mHi;
+    float32 mBallRadius;
+
+    // budget
+    std::size_t mMaxParticles;
+    float32 mDetail;
+    float32 mFrameTime;
+    std::vector<std::size_t> mOrder;
+    std::mt19937 mRNG;
+
+    sf::Time mLastUpdate;
+    const sf::Texture *mTexture;
+    sf::VertexArray mVertices;
+    bool mUseShader;
+    const sf::Shader *mShader;
+  };
+
+}
+
+#endif // __PARTICLESYSTEM_H_
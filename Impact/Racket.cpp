@@ -31,12 +31,11 @@ namespace Impact {
     : Body(Body::BodyType::Racket, game, tileParam)
   {
     mName = Name;
-    mTexture = mGame->level()->texture(mName);
-    setSmooth(mTileParam.smooth);
-    mSprite.setTexture(mTexture);
-    mSprite.setOrigin(sf::Vector2f(.5f * mTexture.getSize().x, .5f * mTexture.getSize().y));
+    const sf::Vector2u &textureSize = mGame->level()->textureSize(mName);
+    mSprite.setTexture(mGame->level()->texture(mName));
+    mSprite.setOrigin(sf::Vector2f(.5f * textureSize.x, .5f * textureSize.y));
 
-    setHalfTextureSize(mTexture);
+    setHalfTextureSize(textureSize);
 
     b2BodyDef bd;
     bd.type = b2_dynamicBody;
@@ -45,8 +44,8 @@ namespace Impact {
 
     b2PolygonShape polygon;
     const float32 hs = .5f * Game::InvScale;
-    const float32 hh = hs * mTexture.getSize().y;
-    const float32 xoff = hs * (mTexture.getSize().x - mTexture.getSize().y);
+    const float32 hh = hs * textureSize.y;
+    const float32 xoff = hs * (textureSize.x - textureSize.y);
     polygon.SetAsBox(xoff, hh);
 
     const float32 density = tileParam.density.isValid() ? tileParam.density.get() : DefaultDensity;
@@ -127,8 +126,8 @@ namespace Impact {
 
   void Racket::setXAxisConstraint(float32 y)
   {
-    const float32 W = float32(mTexture.getSize().x);
-    const float32 H = float32(mTexture.getSize().y);
+    const float32 W = float32(mTileParam.textureSize.x);
+    const float32 H = float32(mTileParam.textureSize.y);
     b2BodyDef bd;
     bd.position.y = y;
     b2Body *xAxis = mGame->world()->CreateBody(&bd);
@@ -202,8 +201,9 @@ namespace Impact {
   void Racket::onUpdate(float elapsedSeconds)
   {
     UNUSED(elapsedSeconds);
-    mSprite.setPosition(Game::Scale * mTiltingBody->GetPosition().x, Game::Scale * mTiltingBody->GetPosition().y);
-    mSprite.setRotation(rad2deg(mTiltingBody->GetAngle()));
+    const b2Vec2 pos = interpolatedPosition();
+    mSprite.setPosition(Game::Scale * pos.x, Game::Scale * pos.y);
+    mSprite.setRotation(rad2deg(interpolatedAngle()));
   }
 
 
@@ -158,6 +158,7 @@ namespace Impact {
 
   void Recorder::capture(void)
   {
+    Trace::setThreadName("recorder");
     HRESULT hr = S_OK;
     UINT32 packetLength = 0;
     while (!mDoQuit) {
@@ -426,6 +427,7 @@ namespace Impact {
 
   HRESULT Recorder::copyAudioData(float32 *pData, UINT32 nFrames)
   {
+    TRACE_SCOPE("Recorder::copyAudioData");
     // pData contains nFrames frames of float32 samples
     const int nBytesPerOutputFrame = sizeof(sample_t) * mWFX->nChannels;
     const int nOutputBufSize = nFrames * nBytesPerOutputFrame;
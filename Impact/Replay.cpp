@@ -0,0 +1,196 @@
+/*
+
+    Copyright (c) 2015 Oliver Lau <ola@ct.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+
+#include "stdafx.h"
+
+#include <zlib.h>
+
+namespace Impact {
+
+  const uint32_t Replay::Magic = 0x52504d49U; // "IMPR"
+  const uint32_t Replay::Version = 1;
+  const std::string Replay::FileExtension = ".impr";
+
+
+  template <typename T>
+  static void writeValue(std::ostream &os, const T &value)
+  {
+    os.write(reinterpret_cast<const char*>(&value), sizeof(T));
+  }
+
+
+  template <typename T>
+  static void readValue(std::istream &is, T &value)
+  {
+    is.read(reinterpret_cast<char*>(&value), sizeof(T));
+  }
+
+
+  static void writeString(std::ostream &os, const std::string &str)
+  {
+    writeValue(os, uint32_t(str.size()));
+    os.write(str.data(), str.size());
+  }
+
+
+  static void readString(std::istream &is, std::string &str)
+  {
+    uint32_t size = 0;
+    readValue(is, size);
+    if (!is.good() || size > 4096U) {
+      is.setstate(std::ios::failbit);
+      return;
+    }
+    str.resize(size);
+    if (size > 0)
+      is.read(&str[0], size);
+  }
+
+
+  Replay::Replay(void)
+    : mCursor(0)
+  { /* ... */ }
+
+
+  void Replay::clear(void)
+  {
+    mHeader = Header();
+    mFrames.clear();
+    mCursor = 0;
+  }
+
+
+  void Replay::record(const ReplayFrame &frame)
+  {
+    mFrames.push_back(frame);
+  }
+
+
+  void Replay::rewind(void)
+  {
+    mCursor = 0;
+  }
+
+
+  bool Replay::save(const std::string &filename) const
+  {
+    static_assert(sizeof(ReplayFrame) == 12, "ReplayFrame must not contain any padding");
+    const uLong rawSize = uLong(mFrames.size() * sizeof(ReplayFrame));
+    uLongf packedSize = compressBound(rawSize);
+    std::vector<Bytef> packed(packedSize);
+    if (rawSize > 0) {
+      int rc = compress(packed.data(), &packedSize, reinterpret_cast<const Bytef*>(mFrames.data()), rawSize);
+      if (rc != Z_OK) {
+        std::cerr << "Cannot compress replay data (error " << rc << ")" << std::endl;
+        return false;
+      }
+    }
+    else {
+      packedSize = 0;
+    }
+
+    std::ofstream os(filename, std::ios::binary);
+    if (!os.is_open()) {
+      std::cerr << "Cannot open " << filename << " for writing" << std::endl;
+      return false;
+    }
+    writeValue(os, Magic);
+    writeValue(os, Version);
+    writeValue(os, mHeader.seed);
+    writeValue(os, mHeader.tickRate);
+    writeValue(os, mHeader.velocityIterations);
+    writeValue(os, mHeader.positionIterations);
+    writeValue(os, mHeader.particlesPerExplosion);
+    writeValue(os, mHeader.levelNum);
+    writeString(os, mHeader.levelHash);
+    writeString(os, mHeader.zipFilename);
+    writeValue(os, uint32_t(mFrames.size()));
+    writeValue(os, uint32_t(packedSize));
+    os.write(reinterpret_cast<const char*>(packed.data()), packedSize);
+    return os.good();
+  }
+
+
+  bool Replay::load(const std::string &filename)
+  {
+    clear();
+    std::ifstream is(filename, std::ios::binary);
+    if (!is.is_open()) {
+      std::cerr << "Cannot open " << filename << std::endl;
+      return false;
+    }
+    uint32_t magic = 0;
+    uint32_t version = 0;
+    readValue(is, magic);
+    readValue(is, version);
+    if (magic != Magic || version != Version) {
+      std::cerr << filename << " is not a replay file or has an unsupported version" << std::endl;
+      return false;
+    }
+    readValue(is, mHeader.seed);
+    readValue(is, mHeader.tickRate);
+    readValue(is, mHeader.velocityIterations);
+    readValue(is, mHeader.positionIterations);
+    readValue(is, mHeader.particlesPerExplosion);
+    readValue(is, mHeader.levelNum);
+    readString(is, mHeader.levelHash);
+    readString(is, mHeader.zipFilename);
+    uint32_t frameCount = 0;
+    uint32_t packedSize = 0;
+    readValue(is, frameCount);
+    readValue(is, packedSize);
+    if (!is.good()) {
+      std::cerr << filename << " is truncated" << std::endl;
+      return false;
+    }
+    // sizes come straight from the file, so check them before allocating anything
+    const std::streampos dataStart = is.tellg();
+    is.seekg(0, std::ios::end);
+    const std::streamoff remaining = is.tellg() - dataStart;
+    is.seekg(dataStart);
+    if (std::streamoff(packedSize) > remaining) {
+      std::cerr << filename << " is truncated" << std::endl;
+      return false;
+    }
+    if (frameCount > MaxFrames || uint64_t(frameCount) * sizeof(ReplayFrame) > uint64_t(packedSize) * MaxCompressionRatio) {
+      std::cerr << filename << " is corrupt (bad frame count " << frameCount << ")" << std::endl;
+      return false;
+    }
+    std::vector<Bytef> packed(packedSize);
+    if (packedSize > 0)
+      is.read(reinterpret_cast<char*>(packed.data()), packedSize);
+    if (!is.good()) {
+      std::cerr << filename << " is truncated" << std::endl;
+      return false;
+    }
+    mFrames.resize(frameCount);
+    uLongf rawSize = uLongf(frameCount * sizeof(ReplayFrame));
+    if (frameCount > 0) {
+      int rc = uncompress(reinterpret_cast<Bytef*>(mFrames.data()), &rawSize, packed.data(), packedSize);
+      if (rc != Z_OK || rawSize != frameCount * sizeof(ReplayFrame)) {
+        std::cerr << "Cannot decompress replay data in " << filename << " (error " << rc << ")" << std::endl;
+        mFrames.clear();
+        return false;
+      }
+    }
+    return true;
+  }
+
+}
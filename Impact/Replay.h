@@ -0,0 +1,131 @@
+/*
+
+    Copyright (c) 2015 Oliver Lau <ola@ct.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#ifndef __REPLAY_H_
+#define __REPLAY_H_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace Impact {
+
+  /// Player input as it was fed into the simulation during one frame.
+  struct ReplayFrame {
+    typedef enum _Input {
+      NoInput = 0,
+      KickLeft = 1 << 0,
+      KickRight = 1 << 1,
+      NewBall = 1 << 2,
+      ExtraBall = 1 << 3,
+      RecoverBall = 1 << 4,
+      ClampRacket = 1 << 5,
+      EventMask = NewBall | ExtraBall | RecoverBall | ClampRacket
+    } Input;
+
+    ReplayFrame(void)
+      : tick(0)
+      , steps(0)
+      , x(0)
+      , y(0)
+      , input(NoInput)
+    { /* ... */ }
+    /// physics tick at which the input was applied
+    uint32_t tick;
+    /// number of physics steps run after applying the input
+    uint16_t steps;
+    /// mouse position handed to Racket::moveTo() (in pixels)
+    int16_t x;
+    int16_t y;
+    /// combination of Input flags
+    uint16_t input;
+  };
+
+
+  class Replay {
+  public:
+    static const uint32_t Magic;
+    static const uint32_t Version;
+    static const std::string FileExtension;
+    static const uint32_t MaxFrames = 24U * 60U * 60U * 240U; // a day at 240 fps
+    static const uint32_t MaxCompressionRatio = 1032U; // deflate can't do better than that
+
+    struct Header {
+      Header(void)
+        : seed(0)
+        , tickRate(0)
+        , velocityIterations(0)
+        , positionIterations(0)
+        , particlesPerExplosion(0)
+        , levelNum(0)
+      { /* ... */ }
+      uint32_t seed;
+      int32_t tickRate;
+      int32_t velocityIterations;
+      int32_t positionIterations;
+      int32_t particlesPerExplosion;
+      int32_t levelNum;
+      std::string levelHash;
+      std::string zipFilename;
+    };
+
+    Replay(void);
+
+    void clear(void);
+    bool save(const std::string &filename) const;
+    bool load(const std::string &filename);
+
+    inline Header &header(void)
+    {
+      return mHeader;
+    }
+    inline const Header &header(void) const
+    {
+      return mHeader;
+    }
+
+    void record(const ReplayFrame &);
+
+    void rewind(void);
+    inline bool atEnd(void) const
+    {
+      return mCursor >= mFrames.size();
+    }
+    inline const ReplayFrame &current(void) const
+    {
+      return mFrames[mCursor];
+    }
+    inline void next(void)
+    {
+      ++mCursor;
+    }
+    inline bool isEmpty(void) const
+    {
+      return mFrames.empty();
+    }
+
+  private:
+    Header mHeader;
+    std::vector<ReplayFrame> mFrames;
+    std::vector<ReplayFrame>::size_type mCursor;
+  };
+
+}
+
+#endif // __REPLAY_H_
@@ -37,15 +37,15 @@ namespace Impact {
     , mElapsedSeconds(0.f)
     , mMouseDown(false)
   {
-    mScrollbarTexture.loadFromFile(ImagesDir + "/white-pixel.png");
-    mScrollbarTexture.setSmooth(false);
-    mScrollbarSprite.setTexture(mScrollbarTexture);
     mContentsSprite.setScale(1.f, -1.f);
   }
 
 
   void ScrollArea::create(unsigned int width, unsigned int height)
   {
+    mScrollbarTexture.loadFromFile(ImagesDir + "/white-pixel.png");
+    mScrollbarTexture.setSmooth(false);
+    mScrollbarSprite.setTexture(mScrollbarTexture);
     mRenderTexture.create(width, height);
     mRenderView = mRenderTexture.getDefaultView();
     mTotalArea = sf::FloatRect(sf::Vector2f(), sf::Vector2f(mRenderView.getSize().x, mRenderView.getSize().y));
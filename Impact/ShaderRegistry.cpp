@@ -0,0 +1,86 @@
+/*
+
+    Copyright (c) 2015 Oliver Lau <ola@ct.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+
+#include "stdafx.h"
+
+namespace Impact {
+
+  std::map<std::string, sf::Shader*> ShaderRegistry::sShaders;
+
+
+  sf::Shader *ShaderRegistry::fragment(const std::string &fragmentShaderFilename)
+  {
+    return lookup(fragmentShaderFilename, std::string(), fragmentShaderFilename);
+  }
+
+
+  sf::Shader *ShaderRegistry::program(const std::string &vertexShaderFilename, const std::string &fragmentShaderFilename)
+  {
+    return lookup(vertexShaderFilename + "|" + fragmentShaderFilename, vertexShaderFilename, fragmentShaderFilename);
+  }
+
+
+  sf::Shader *ShaderRegistry::lookup(const std::string &key, const std::string &vertexShaderFilename, const std::string &fragmentShaderFilename)
+  {
+    std::map<std::string, sf::Shader*>::const_iterator s = sShaders.find(key);
+    if (s != sShaders.end())
+      return s->second;
+    sf::Shader *shader = new sf::Shader;
+    const bool ok = vertexShaderFilename.empty()
+      ? shader->loadFromFile(fragmentShaderFilename, sf::Shader::Fragment)
+      : shader->loadFromFile(vertexShaderFilename, fragmentShaderFilename);
+    return remember(key, shader, ok);
+  }
+
+
+  sf::Shader *ShaderRegistry::variant(const std::string &fragmentShaderFilename, const std::string &defines)
+  {
+    const std::string &key = fragmentShaderFilename + "|" + defines;
+    std::map<std::string, sf::Shader*>::const_iterator s = sShaders.find(key);
+    if (s != sShaders.end())
+      return s->second;
+    std::ifstream in(fragmentShaderFilename.c_str(), std::ios::binary);
+    std::string code((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    // #version must stay the first statement
+    std::string::size_type pos = 0;
+    if (code.compare(0, 8, "#version") == 0) {
+      pos = code.find('\n');
+      pos = (pos == std::string::npos) ? code.size() : pos + 1;
+    }
+    code.insert(pos, defines);
+    sf::Shader *shader = new sf::Shader;
+    const bool ok = in.is_open() && shader->loadFromMemory(code, sf::Shader::Fragment);
+    return remember(key, shader, ok);
+  }
+
+
+  sf::Shader *ShaderRegistry::remember(const std::string &key, sf::Shader *shader, bool ok)
+  {
+    if (!ok) {
+      std::cerr << key << " failed to load/compile." << std::endl;
+      delete shader;
+      shader = nullptr;
+    }
+    // remember failures, too, so that a broken shader isn't recompiled for every body
+    sShaders[key] = shader;
+    return shader;
+  }
+
+}
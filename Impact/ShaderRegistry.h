@@ -0,0 +1,51 @@
+/*
+
+    Copyright (c) 2015 Oliver Lau <ola@ct.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#ifndef __SHADERREGISTRY_H_
+#define __SHADERREGISTRY_H_
+
+#include <SFML/Graphics.hpp>
+
+#include <string>
+#include <map>
+
+namespace Impact {
+
+  /// Compiles every shader program once per process and hands out
+  /// the same instance to all bodies using it. As the program is shared,
+  /// a body must set all of its uniforms right before drawing.
+  /// Only to be used from the main thread.
+  class ShaderRegistry {
+  public:
+    static sf::Shader *fragment(const std::string &fragmentShaderFilename);
+    static sf::Shader *program(const std::string &vertexShaderFilename, const std::string &fragmentShaderFilename);
+    /// One variant of a fragment shader, with `defines` (e.g. "#define FOO\n")
+    /// inserted after its #version line.
+    static sf::Shader *variant(const std::string &fragmentShaderFilename, const std::string &defines);
+
+  private:
+    static sf::Shader *lookup(const std::string &key, const std::string &vertexShaderFilename, const std::string &fragmentShaderFilename);
+    static sf::Shader *remember(const std::string &key, sf::Shader *shader, bool ok);
+    // shaders are never freed: they may outlive the GL context otherwise
+    static std::map<std::string, sf::Shader*> sShaders;
+  };
+
+}
+
+#endif // __SHADERREGISTRY_H_
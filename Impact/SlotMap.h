@@ -0,0 +1,182 @@
+/*
+
+    Copyright (c) 2015 Oliver Lau <ola@ct.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#ifndef __SLOTMAP_H_
+#define __SLOTMAP_H_
+
+#include <vector>
+#include <cstdint>
+#include <cassert>
+
+namespace Impact {
+
+  /// Refers to an element of a SlotMap. A handle outlives the element
+  /// it refers to: once the element has been erased, looking it up
+  /// yields nullptr instead of whatever took over its slot.
+  struct SlotHandle {
+    static const uint32_t InvalidIndex = 0xffffffffU;
+    SlotHandle(void)
+      : index(InvalidIndex)
+      , generation(0)
+    { /* ... */ }
+    SlotHandle(uint32_t index, uint32_t generation)
+      : index(index)
+      , generation(generation)
+    { /* ... */ }
+    inline bool isValid(void) const
+    {
+      return index != InvalidIndex;
+    }
+    inline bool operator==(const SlotHandle &other) const
+    {
+      return index == other.index && generation == other.generation;
+    }
+    inline bool operator!=(const SlotHandle &other) const
+    {
+      return !(*this == other);
+    }
+    uint32_t index;
+    uint32_t generation;
+  };
+
+
+  /// Keeps its elements densely packed for fast iteration and hands
+  /// out generational handles for O(1) lookup and removal. Removal
+  /// moves the last element into the gap, so the iteration order is
+  /// not preserved.
+  template <typename T>
+  class SlotMap {
+  public:
+    typedef typename std::vector<T>::iterator iterator;
+    typedef typename std::vector<T>::const_iterator const_iterator;
+    typedef typename std::vector<T>::size_type size_type;
+
+    SlotMap(void)
+      : mFreeHead(SlotHandle::InvalidIndex)
+    { /* ... */ }
+
+    SlotHandle insert(const T &value)
+    {
+      uint32_t slotIndex;
+      if (mFreeHead != SlotHandle::InvalidIndex) {
+        slotIndex = mFreeHead;
+        mFreeHead = mSlots[slotIndex].dense;
+      }
+      else {
+        slotIndex = uint32_t(mSlots.size());
+        mSlots.push_back(Slot());
+      }
+      Slot &slot = mSlots[slotIndex];
+      slot.dense = uint32_t(mDense.size());
+      mDense.push_back(value);
+      mDenseToSlot.push_back(slotIndex);
+      return SlotHandle(slotIndex, slot.generation);
+    }
+
+    bool erase(const SlotHandle &handle)
+    {
+      if (!contains(handle))
+        return false;
+      Slot &slot = mSlots[handle.index];
+      const uint32_t dense = slot.dense;
+      const uint32_t last = uint32_t(mDense.size() - 1);
+      if (dense != last) {
+        mDense[dense] = mDense[last];
+        mDenseToSlot[dense] = mDenseToSlot[last];
+        mSlots[mDenseToSlot[dense]].dense = dense;
+      }
+      mDense.pop_back();
+      mDenseToSlot.pop_back();
+      ++slot.generation;
+      slot.dense = mFreeHead;
+      mFreeHead = handle.index;
+      return true;
+    }
+
+    inline bool contains(const SlotHandle &handle) const
+    {
+      return handle.index < mSlots.size() && mSlots[handle.index].generation == handle.generation;
+    }
+
+    inline T *get(const SlotHandle &handle)
+    {
+      return contains(handle) ? &mDense[mSlots[handle.index].dense] : nullptr;
+    }
+
+    inline const T *get(const SlotHandle &handle) const
+    {
+      return contains(handle) ? &mDense[mSlots[handle.index].dense] : nullptr;
+    }
+
+    /// invalidates all handles handed out so far, but keeps the memory
+    void clear(void)
+    {
+      for (std::vector<uint32_t>::const_iterator s = mDenseToSlot.cbegin(); s != mDenseToSlot.cend(); ++s) {
+        Slot &slot = mSlots[*s];
+        ++slot.generation;
+        slot.dense = mFreeHead;
+        mFreeHead = *s;
+      }
+      mDense.clear();
+      mDenseToSlot.clear();
+    }
+
+    inline size_type size(void) const
+    {
+      return mDense.size();
+    }
+    inline bool empty(void) const
+    {
+      return mDense.empty();
+    }
+
+    inline T &operator[](size_type i)
+    {
+      return mDense[i];
+    }
+    inline const T &operator[](size_type i) const
+    {
+      return mDense[i];
+    }
+
+    inline iterator begin(void) { return mDense.begin(); }
+    inline iterator end(void) { return mDense.end(); }
+    inline const_iterator begin(void) const { return mDense.begin(); }
+    inline const_iterator end(void) const { return mDense.end(); }
+    inline const_iterator cbegin(void) const { return mDense.cbegin(); }
+    inline const_iterator cend(void) const { return mDense.cend(); }
+
+  private:
+    struct Slot {
+      Slot(void)
+        : dense(0)
+        , generation(0)
+      { /* ... */ }
+      uint32_t dense; // index into mDense, or next free slot
+      uint32_t generation;
+    };
+    std::vector<T> mDense;
+    std::vector<uint32_t> mDenseToSlot;
+    std::vector<Slot> mSlots;
+    uint32_t mFreeHead;
+  };
+
+}
+
+#endif // __SLOTMAP_H_
@@ -0,0 +1,71 @@
+/*
+
+    Copyright (c) 2015 Oliver Lau <ola@ct.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+
+#include "stdafx.h"
+
+
+namespace Impact {
+
+  SpriteBatch::SpriteBatch(void)
+    : mVertices(sf::Quads)
+    , mTexture(nullptr)
+  { /* ... */ }
+
+
+  void SpriteBatch::clear(void)
+  {
+    mVertices.clear();
+  }
+
+
+  void SpriteBatch::setTexture(const sf::Texture *texture)
+  {
+    mTexture = texture;
+  }
+
+
+  void SpriteBatch::add(const sf::Sprite &sprite)
+  {
+    // same geometry sf::Sprite would create, but transformed on the CPU
+    const sf::Transform &transform = sprite.getTransform();
+    const sf::IntRect &r = sprite.getTextureRect();
+    const float left = float(r.left);
+    const float top = float(r.top);
+    const float right = left + float(r.width);
+    const float bottom = top + float(r.height);
+    const float w = float(std::abs(r.width));
+    const float h = float(std::abs(r.height));
+    const sf::Color &color = sprite.getColor();
+    mVertices.append(sf::Vertex(transform.transformPoint(0.f, 0.f), color, sf::Vector2f(left, top)));
+    mVertices.append(sf::Vertex(transform.transformPoint(w, 0.f), color, sf::Vector2f(right, top)));
+    mVertices.append(sf::Vertex(transform.transformPoint(w, h), color, sf::Vector2f(right, bottom)));
+    mVertices.append(sf::Vertex(transform.transformPoint(0.f, h), color, sf::Vector2f(left, bottom)));
+  }
+
+
+  void SpriteBatch::draw(sf::RenderTarget &target, sf::RenderStates states) const
+  {
+    if (mVertices.getVertexCount() == 0)
+      return;
+    states.texture = mTexture;
+    target.draw(mVertices, states);
+  }
+
+}
@@ -0,0 +1,51 @@
+/*
+
+    Copyright (c) 2015 Oliver Lau <ola@ct.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#ifndef __SPRITEBATCH_H_
+#define __SPRITEBATCH_H_
+
+#include <SFML/Graphics.hpp>
+
+namespace Impact {
+
+  /// Collects sprites that share a texture into one vertex array, so
+  /// that they can be drawn with a single draw call.
+  class SpriteBatch : public sf::Drawable {
+  public:
+    SpriteBatch(void);
+
+    void clear(void);
+    void setTexture(const sf::Texture *texture);
+    void add(const sf::Sprite &sprite);
+
+    inline std::size_t size(void) const
+    {
+      return mVertices.getVertexCount() / 4;
+    }
+
+  private:
+    virtual void draw(sf::RenderTarget &target, sf::RenderStates states) const;
+
+    sf::VertexArray mVertices;
+    const sf::Texture *mTexture;
+  };
+
+}
+
+#endif // __SPRITEBATCH_H_
@@ -25,6 +25,13 @@ namespace Impact {
   TextBody::TextBody(const TextBodyDef &def)
     : Body(Body::BodyType::Text, def.game)
   {
+    init(def);
+  }
+
+
+  void TextBody::init(const TextBodyDef &def)
+  {
+    revive();
     setLifetime(def.maxAge);
     mText.setCharacterSize(def.size);
     mText.setFont(def.font);
@@ -44,9 +51,8 @@ namespace Impact {
   void TextBody::onUpdate(float elapsedSeconds)
   {
     UNUSED(elapsedSeconds);
-    mText.setPosition(Game::Scale * mBody->GetPosition().x, Game::Scale * mBody->GetPosition().y);
-    if (overAge())
-      this->kill();
+    const b2Vec2 pos = interpolatedPosition();
+    mText.setPosition(Game::Scale * pos.x, Game::Scale * pos.y);
   }
 
 
@@ -63,6 +63,7 @@ namespace Impact {
   {
   public:
     TextBody(const TextBodyDef &);
+    void init(const TextBodyDef &);
 
     // Body implementation
     virtual void onUpdate(float elapsedSeconds);
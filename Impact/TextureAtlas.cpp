@@ -0,0 +1,104 @@
+/*
+
+    Copyright (c) 2015 Oliver Lau <ola@ct.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+
+#include "stdafx.h"
+
+
+namespace Impact {
+
+  TextureAtlas::TextureAtlas(void)
+  { /* ... */ }
+
+
+  void TextureAtlas::clear(void)
+  {
+    mPending.clear();
+    mRects.clear();
+  }
+
+
+  void TextureAtlas::add(int id, const sf::Image &image)
+  {
+    Entry entry;
+    entry.id = id;
+    entry.image = image;
+    mPending.push_back(entry);
+  }
+
+
+  bool TextureAtlas::build(void)
+  {
+    TRACE_SCOPE("TextureAtlas::build");
+    // simple shelf packing: tiles tend to come in a few sizes only, so
+    // sorting them by height leaves hardly any gaps
+    std::sort(mPending.begin(), mPending.end(), [](const Entry &a, const Entry &b) {
+      return a.image.getSize().y > b.image.getSize().y;
+    });
+    unsigned int width = DefaultWidth;
+    for (std::vector<Entry>::const_iterator e = mPending.cbegin(); e != mPending.cend(); ++e)
+      width = std::max(width, e->image.getSize().x + 2 * Margin);
+
+    std::vector<sf::Vector2u> positions;
+    unsigned int x = 0;
+    unsigned int y = 0;
+    unsigned int shelfHeight = 0;
+    for (std::vector<Entry>::const_iterator e = mPending.cbegin(); e != mPending.cend(); ++e) {
+      const unsigned int w = e->image.getSize().x + 2 * Margin;
+      const unsigned int h = e->image.getSize().y + 2 * Margin;
+      if (x + w > width) {
+        x = 0;
+        y += shelfHeight;
+        shelfHeight = 0;
+      }
+      positions.push_back(sf::Vector2u(x, y));
+      x += w;
+      shelfHeight = std::max(shelfHeight, h);
+    }
+    const unsigned int height = y + shelfHeight;
+    if (height == 0 || height > sf::Texture::getMaximumSize()) {
+      std::cerr << "Tile images don't fit into a texture atlas of " << width << "x" << sf::Texture::getMaximumSize() << " pixels." << std::endl;
+      mPending.clear();
+      return false;
+    }
+
+    sf::Image atlas;
+    atlas.create(width, height, sf::Color(0, 0, 0, 0));
+    for (std::vector<Entry>::size_type i = 0; i < mPending.size(); ++i) {
+      const Entry &e = mPending[i];
+      const sf::Vector2u &p = positions[i];
+      atlas.copy(e.image, p.x + Margin, p.y + Margin);
+      mRects[e.id] = sf::IntRect(p.x + Margin, p.y + Margin, e.image.getSize().x, e.image.getSize().y);
+    }
+    mPending.clear();
+    const bool ok = mTexture.loadFromImage(atlas);
+    // Level only adds tiles that want to be smoothed
+    mTexture.setSmooth(true);
+    if (!ok)
+      mRects.clear();
+    return ok;
+  }
+
+
+  const sf::IntRect &TextureAtlas::rect(int id) const
+  {
+    return mRects.at(id);
+  }
+
+}
@@ -0,0 +1,68 @@
+/*
+
+    Copyright (c) 2015 Oliver Lau <ola@ct.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#ifndef __TEXTUREATLAS_H_
+#define __TEXTUREATLAS_H_
+
+#include <SFML/Graphics.hpp>
+
+#include <vector>
+#include <map>
+
+namespace Impact {
+
+  /// Packs the tile images of a level into a single texture, so that
+  /// all bodies drawn from it can share one texture bind. Every image
+  /// gets a transparent margin, which leaves room for rotated sprites
+  /// and for shaders sampling around them.
+  class TextureAtlas {
+  public:
+    TextureAtlas(void);
+
+    static const unsigned int DefaultWidth = 512U;
+    static const int Margin = 8;
+
+    void clear(void);
+    void add(int id, const sf::Image &image);
+    bool build(void);
+
+    inline const sf::Texture &texture(void) const
+    {
+      return mTexture;
+    }
+    inline bool contains(int id) const
+    {
+      return mRects.find(id) != mRects.end();
+    }
+    /// the area of the image with the given id, without margin
+    const sf::IntRect &rect(int id) const;
+
+  private:
+    struct Entry {
+      int id;
+      sf::Image image;
+    };
+    std::vector<Entry> mPending;
+    std::map<int, sf::IntRect> mRects;
+    sf::Texture mTexture;
+  };
+
+}
+
+#endif // __TEXTUREATLAS_H_
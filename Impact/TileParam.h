@@ -24,6 +24,7 @@
 #include <SFML/System.hpp>
 #include <SFML/Graphics.hpp>
 #include <string>
+#include <memory>
 
 #include "util.h"
 
@@ -66,11 +67,12 @@ namespace Impact {
       , bumperImpulse(other.bumperImpulse)
       , multiball(other.multiball)
       , keyholeEffect(other.keyholeEffect)
+      , textureSize(other.textureSize)
+      , texture(other.texture)
     { /* ... */
     }
     int64_t score;
     std::string textureName;
-    sf::Texture texture;
     DynamicValue<bool> fixed;
     DynamicValue<float32> friction;
     DynamicValue<float32> linearDamping;
@@ -91,6 +93,9 @@ namespace Impact {
     float32 bumperImpulse;
     bool multiball;
     bool keyholeEffect;
+    sf::Vector2u textureSize;
+    // shared by all copies, so copying a tile never touches the GPU
+    std::shared_ptr<sf::Texture> texture;
   };
 
 
@@ -0,0 +1,116 @@
+/*
+
+    Copyright (c) 2015 Oliver Lau <ola@ct.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+
+#include "stdafx.h"
+
+namespace Impact {
+
+  std::atomic<bool> Trace::sRunning(false);
+  std::mutex Trace::sMutex;
+  sf::Clock Trace::sClock;
+  std::string Trace::sFilename;
+  std::vector<Trace::Event> Trace::sEvents;
+  std::vector<Trace::ThreadName> Trace::sThreadNames;
+
+
+  void Trace::start(const std::string &filename)
+  {
+    std::lock_guard<std::mutex> lock(sMutex);
+    sFilename = filename;
+    sEvents.clear();
+    sEvents.reserve(64 * 1024);
+    sClock.restart();
+    sRunning = true;
+  }
+
+
+  bool Trace::stop(void)
+  {
+    if (!sRunning)
+      return false;
+    sRunning = false;
+    std::lock_guard<std::mutex> lock(sMutex);
+    std::ofstream os(sFilename);
+    if (!os.is_open()) {
+      std::cerr << "Cannot open " << sFilename << " for writing" << std::endl;
+      return false;
+    }
+    // Chrome wants small integer thread ids
+    std::vector<std::thread::id> tids;
+    auto tidIndex = [&tids](std::thread::id tid) -> int {
+      std::vector<std::thread::id>::const_iterator t = std::find(tids.cbegin(), tids.cend(), tid);
+      if (t != tids.cend())
+        return int(t - tids.cbegin()) + 1;
+      tids.push_back(tid);
+      return int(tids.size());
+    };
+    os << "{\"traceEvents\":[" << std::endl;
+    bool first = true;
+    for (std::vector<ThreadName>::const_iterator t = sThreadNames.cbegin(); t != sThreadNames.cend(); ++t) {
+      os << (first ? "" : ",\n")
+        << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << tidIndex(t->tid)
+        << ",\"args\":{\"name\":\"" << t->name << "\"}}";
+      first = false;
+    }
+    for (std::vector<Event>::const_iterator e = sEvents.cbegin(); e != sEvents.cend(); ++e) {
+      os << (first ? "" : ",\n")
+        << "{\"name\":\"" << e->name << "\",\"cat\":\"impact\",\"ph\":\"X\",\"pid\":1,\"tid\":" << tidIndex(e->tid)
+        << ",\"ts\":" << e->start << ",\"dur\":" << e->duration << "}";
+      first = false;
+    }
+    os << std::endl << "]}" << std::endl;
+    sEvents.clear();
+#ifndef NDEBUG
+    std::cout << "Trace saved to " << sFilename << std::endl;
+#endif
+    return os.good();
+  }
+
+
+  sf::Int64 Trace::now(void)
+  {
+    return sClock.getElapsedTime().asMicroseconds();
+  }
+
+
+  void Trace::record(const char *name, sf::Int64 start, sf::Int64 duration)
+  {
+    if (!sRunning)
+      return;
+    Event e;
+    e.name = name;
+    e.tid = std::this_thread::get_id();
+    e.start = start;
+    e.duration = duration;
+    std::lock_guard<std::mutex> lock(sMutex);
+    sEvents.push_back(e);
+  }
+
+
+  void Trace::setThreadName(const std::string &name)
+  {
+    std::lock_guard<std::mutex> lock(sMutex);
+    ThreadName t;
+    t.tid = std::this_thread::get_id();
+    t.name = name;
+    sThreadNames.push_back(t);
+  }
+
+}
@@ -0,0 +1,105 @@
+/*
+
+    Copyright (c) 2015 Oliver Lau <ola@ct.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#ifndef __TRACE_H_
+#define __TRACE_H_
+
+#include <SFML/System.hpp>
+
+#include <string>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <atomic>
+
+namespace Impact {
+
+  /// Collects timed scopes from all threads and writes them in
+  /// Chrome's trace event format (chrome://tracing, ui.perfetto.dev).
+  class Trace {
+  public:
+    static void start(const std::string &filename);
+    static bool stop(void);
+    static inline bool isRunning(void)
+    {
+      return sRunning;
+    }
+    static sf::Int64 now(void);
+    static void record(const char *name, sf::Int64 start, sf::Int64 duration);
+    static void setThreadName(const std::string &name);
+
+  private:
+    struct Event {
+      const char *name;
+      std::thread::id tid;
+      sf::Int64 start;
+      sf::Int64 duration;
+    };
+    struct ThreadName {
+      std::thread::id tid;
+      std::string name;
+    };
+    static std::atomic<bool> sRunning;
+    static std::mutex sMutex;
+    static sf::Clock sClock;
+    static std::string sFilename;
+    static std::vector<Event> sEvents;
+    static std::vector<ThreadName> sThreadNames;
+  };
+
+
+  class TraceScope {
+  public:
+#ifndef NO_TRACE
+    TraceScope(const char *name)
+      : mName(name)
+      , mStart(Trace::isRunning() ? Trace::now() : -1)
+    { /* ... */ }
+    ~TraceScope()
+    {
+      end();
+    }
+    inline void end(void)
+    {
+      if (mStart >= 0) {
+        Trace::record(mName, mStart, Trace::now() - mStart);
+        mStart = -1;
+      }
+    }
+
+  private:
+    const char *mName;
+    sf::Int64 mStart;
+#else
+    TraceScope(const char *) { /* ... */ }
+    inline void end(void) { /* ... */ }
+#endif
+  };
+
+}
+
+#ifndef NO_TRACE
+#define TRACE_CONCAT_(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_(a, b)
+#define TRACE_SCOPE(name) Impact::TraceScope TRACE_CONCAT(traceScope, __LINE__)(name)
+#else
+#define TRACE_SCOPE(name)
+#endif
+
+#endif // __TRACE_H_
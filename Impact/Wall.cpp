@@ -32,14 +32,16 @@ namespace Impact {
     : Body(Body::BodyType::Wall, game, tileParam)
   {
     mName = Name;
-    mTexture = mGame->level()->tileParam(index).texture;
+    const TileParam &tile = mGame->level()->tileParam(index);
 
-    setHalfTextureSize(mTexture);
+    setHalfTextureSize(tile.textureSize);
 
-    const float halfW = .5f * mTexture.getSize().x;
-    const float halfH = .5f * mTexture.getSize().y;
+    const float halfW = .5f * tile.textureSize.x;
+    const float halfH = .5f * tile.textureSize.y;
 
-    mSprite.setTexture(mTexture);
+    if (!useAtlas(index)) {
+      mSprite.setTexture(*tile.texture);
+    }
     mSprite.setOrigin(halfW, halfH);
 
     b2BodyDef bd;
@@ -37,6 +37,10 @@ namespace Impact {
     // Body implementation
     virtual void onUpdate(float elapsedSeconds);
     virtual void onDraw(sf::RenderTarget &target, sf::RenderStates states) const;
+    virtual bool isStatic(void) const
+    {
+      return true;
+    }
 
     virtual void setPosition(int x, int y);
     virtual void setPosition(const b2Vec2 &pos);
@@ -0,0 +1,118 @@
+/*
+
+    Copyright (c) 2015 Oliver Lau <ola@ct.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+
+#include "stdafx.h"
+
+
+namespace Impact {
+
+  unsigned int WorkerPool::defaultThreadCount(void)
+  {
+    // the main thread does its share, and there may be a simulation
+    // thread busy with the next physics steps
+    const unsigned int cores = std::thread::hardware_concurrency();
+    return cores > 2 ? cores - 2 : 0;
+  }
+
+
+  WorkerPool::WorkerPool(unsigned int threads)
+    : mJob(nullptr)
+    , mCount(0)
+    , mChunk(1)
+    , mNext(0)
+    , mBusy(0)
+    , mGeneration(0)
+    , mQuit(false)
+  {
+    for (unsigned int i = 0; i < threads; ++i)
+      mThreads.push_back(std::thread(&WorkerPool::threadProc, this, i));
+  }
+
+
+  WorkerPool::~WorkerPool()
+  {
+    {
+      std::unique_lock<std::mutex> lock(mMutex);
+      mQuit = true;
+      mWorkCondition.notify_all();
+    }
+    for (std::vector<std::thread>::iterator t = mThreads.begin(); t != mThreads.end(); ++t)
+      t->join();
+  }
+
+
+  void WorkerPool::run(std::size_t n, std::size_t minChunk, const Job &job)
+  {
+    if (n == 0)
+      return;
+    if (mThreads.empty() || n <= minChunk) {
+      job(0, n);
+      return;
+    }
+    // several chunks per thread even out the load if some ranges take
+    // longer than others
+    const std::size_t parts = 4 * (mThreads.size() + 1);
+    {
+      std::unique_lock<std::mutex> lock(mMutex);
+      mJob = &job;
+      mCount = n;
+      mChunk = std::max(minChunk, (n + parts - 1) / parts);
+      mNext = 0;
+      mBusy = unsigned(mThreads.size());
+      ++mGeneration;
+      mWorkCondition.notify_all();
+    }
+    work();
+    std::unique_lock<std::mutex> lock(mMutex);
+    mDoneCondition.wait(lock, [this]{ return mBusy == 0; });
+    mJob = nullptr;
+  }
+
+
+  void WorkerPool::work(void)
+  {
+    for (;;) {
+      const std::size_t first = mNext.fetch_add(mChunk);
+      if (first >= mCount)
+        break;
+      (*mJob)(first, std::min(first + mChunk, mCount));
+    }
+  }
+
+
+  void WorkerPool::threadProc(unsigned int index)
+  {
+    Trace::setThreadName("worker " + std::to_string(index));
+    unsigned int generation = 0;
+    std::unique_lock<std::mutex> lock(mMutex);
+    for (;;) {
+      mWorkCondition.wait(lock, [this, generation]{ return mQuit || mGeneration != generation; });
+      if (mQuit)
+        break;
+      generation = mGeneration;
+      lock.unlock();
+      work();
+      lock.lock();
+      if (--mBusy == 0)
+        mDoneCondition.notify_all();
+    }
+  }
+
+}
@@ -0,0 +1,71 @@
+/*
+
+    Copyright (c) 2015 Oliver Lau <ola@ct.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#ifndef __WORKERPOOL_H_
+#define __WORKERPOOL_H_
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+
+namespace Impact {
+
+  /// A fixed set of threads that work through index ranges in parallel.
+  /// run() hands out chunks of [0, n) to the workers and to the calling
+  /// thread and returns when all of them are done, so whatever the job
+  /// wrote is visible to the caller afterwards.
+  class WorkerPool {
+  public:
+    typedef std::function<void(std::size_t first, std::size_t last)> Job;
+
+    WorkerPool(unsigned int threads = defaultThreadCount());
+    ~WorkerPool();
+
+    void run(std::size_t n, std::size_t minChunk, const Job &job);
+
+    inline unsigned int size(void) const
+    {
+      return unsigned(mThreads.size());
+    }
+
+    static unsigned int defaultThreadCount(void);
+
+  private:
+    void threadProc(unsigned int index);
+    void work(void);
+
+    std::vector<std::thread> mThreads;
+    std::mutex mMutex;
+    std::condition_variable mWorkCondition;
+    std::condition_variable mDoneCondition;
+    const Job *mJob;
+    std::size_t mCount;
+    std::size_t mChunk;
+    std::atomic<std::size_t> mNext;
+    unsigned int mBusy;
+    unsigned int mGeneration;
+    bool mQuit;
+  };
+
+}
+
+#endif // __WORKERPOOL_H_
@@ -38,4 +38,9 @@ namespace Impact {
     gRNG().seed(seq);
   }
 
+  void seedRNG(uint32_t seed)
+  {
+    gRNG().seed(seed);
+  }
+
 }
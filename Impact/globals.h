@@ -23,6 +23,7 @@
 
 #include <string>
 #include <random>
+#include <cstdint>
 #include "LocalSettings.h"
 
 namespace Impact {
@@ -36,6 +37,7 @@ namespace Impact {
 
   std::mt19937& gRNG();
   extern void warmupRNG(void);
+  extern void seedRNG(uint32_t seed);
 
   LocalSettings& gLocalSettings();
 }
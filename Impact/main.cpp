@@ -26,26 +26,82 @@
 #include <gtk/gtk.h>
 #endif
 
-Impact::Game breakout;
-
 int main(int argc, char *argv[])
 {
+  if (argc > 2 && std::string(argv[1]) == "--trace") {
+    // impact --trace <trace.json> [further options]
+    Impact::Trace::start(argv[2]);
+    Impact::Trace::setThreadName("main");
+    argv[2] = argv[0];
+    argc -= 2;
+    argv += 2;
+  }
+
+  if (argc > 2 && std::string(argv[1]) == "--bench") {
+    // impact --bench <result.json> [baseline.json]
+    bool ok;
+    {
+      Impact::Game benchmark(true);
+      ok = benchmark.runBenchmark(argv[2], argc > 3 ? argv[3] : std::string());
+    }
+    Impact::Trace::stop();
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+  }
+  if (argc > 3 && std::string(argv[1]) == "--headless" && std::string(argv[2]) == "--replay") {
+    // impact --headless --replay <file.impr>
+    bool ok;
+    {
+      Impact::Game simulation(true);
+      ok = simulation.runHeadlessReplay(argv[3]);
+    }
+    Impact::Trace::stop();
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+  }
+  if (argc > 2 && std::string(argv[1]) == "--headless") {
+    // impact --headless <level.zip> [ticks]
+    unsigned int ticks = Impact::Game::DefaultHeadlessTicks;
+    if (argc > 3) {
+      char *end = nullptr;
+      const unsigned long n = std::strtoul(argv[3], &end, 10);
+      if (!std::isdigit(static_cast<unsigned char>(argv[3][0])) || *end != '\0' || n > std::numeric_limits<unsigned int>::max()) {
+        std::cerr << "Bad tick count: '" << argv[3] << "'" << std::endl
+          << "Usage: impact --headless <level.zip> [ticks]" << std::endl;
+        Impact::Trace::stop();
+        return EXIT_FAILURE;
+      }
+      ticks = unsigned(n);
+    }
+    bool ok;
+    {
+      Impact::Game simulation(true);
+      ok = simulation.runHeadless(argv[2], ticks);
+    }
+    Impact::Trace::stop();
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+  }
+
 #if defined(LINUX_AMD64)   
   gtk_init(&argc, &argv);
 #endif
-  if (argc == 2) {
+  Impact::Game breakout;
+  if (argc > 2 && std::string(argv[1]) == "--replay") {
+    // impact --replay <file.impr>
+    breakout.playReplay(argv[2]);
+  }
+  else if (argc == 2) {
 #if defined(WIN32) && defined(CT_VERSION_INTERNAL)
     char szPath[MAX_PATH];
     char *res = _fullpath(szPath, argv[1], MAX_PATH);
     if (res != NULL) {
       DWORD dwAttrib = GetFileAttributes(szPath);
       if (dwAttrib != INVALID_FILE_ATTRIBUTES && !(dwAttrib & FILE_ATTRIBUTE_DIRECTORY))
-        breakout->setLevelZip(szPath);
+        breakout.setLevelZip(szPath);
     }
 #else
     UNUSED(argv);
 #endif
   }
   breakout.loop();
+  Impact::Trace::stop();
   return EXIT_SUCCESS;
 }
@@ -19,25 +19,21 @@
 
 */
 
+// Downsampling half of the dual filter blur: draws into a target half
+// the size of uTexture, averaging the centre and four diagonal taps
+// placed between texels so that bilinear filtering does the rest.
+
 uniform sampler2D uTexture;
-uniform vec2 uRShift;
-uniform vec2 uGShift;
-uniform vec2 uBShift;
-uniform float uT;
-uniform float uMaxT;
-
-float easeOutExpo(float t, float d) {
-  return pow(2.0, -10.0 * t / d);
-}
+uniform vec2 uHalfPixel;
+uniform float uOffset;
 
-void main(void)
-{
+void main(void) {
   vec2 pos = gl_TexCoord[0].xy;
-  float intensity = easeOutExpo(uT / uMaxT, uMaxT - uT);
-  vec3 rgb = vec3(
-    texture2D(uTexture, uRShift * intensity + pos).r,
-    texture2D(uTexture, uGShift * intensity + pos).g,
-    texture2D(uTexture, uBShift * intensity + pos).b
-  );
-  gl_FragColor = vec4(rgb, 1.0);
+  vec2 d = uHalfPixel * uOffset;
+  vec4 sum = texture2D(uTexture, pos) * 4.0;
+  sum += texture2D(uTexture, pos - d);
+  sum += texture2D(uTexture, pos + d);
+  sum += texture2D(uTexture, pos + vec2(d.x, -d.y));
+  sum += texture2D(uTexture, pos - vec2(d.x, -d.y));
+  gl_FragColor = sum / 8.0;
 }
@@ -0,0 +1,42 @@
+#version 110
+
+/*
+
+    Copyright (c) 2015 Oliver Lau <ola@ct.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+// Upsampling half of the dual filter blur: draws into a target twice
+// the size of uTexture from eight taps around the texel. The vertex
+// alpha fades the result over whatever the target already holds.
+
+uniform sampler2D uTexture;
+uniform vec2 uHalfPixel;
+uniform float uOffset;
+
+void main(void) {
+  vec2 pos = gl_TexCoord[0].xy;
+  vec2 d = uHalfPixel * uOffset;
+  vec4 sum = texture2D(uTexture, pos + vec2(-2.0 * d.x, 0.0));
+  sum += texture2D(uTexture, pos + vec2(-d.x, d.y)) * 2.0;
+  sum += texture2D(uTexture, pos + vec2(0.0, 2.0 * d.y));
+  sum += texture2D(uTexture, pos + vec2(d.x, d.y)) * 2.0;
+  sum += texture2D(uTexture, pos + vec2(2.0 * d.x, 0.0));
+  sum += texture2D(uTexture, pos + vec2(d.x, -d.y)) * 2.0;
+  sum += texture2D(uTexture, pos + vec2(0.0, -2.0 * d.y));
+  sum += texture2D(uTexture, pos + vec2(-d.x, -d.y)) * 2.0;
+  gl_FragColor = vec4(sum.rgb / 12.0, gl_Color.a);
+}
@@ -19,11 +19,10 @@
 
 */
 uniform sampler2D uTexture;
-uniform float uAge;
-uniform float uMaxAge;
 
 void main()
 {
-  float v = 1.0 - (uAge / uMaxAge);
+  // the particle system passes 1 - age / lifetime in the vertex alpha
+  float v = gl_Color.a;
   gl_FragColor = texture2D(uTexture, gl_TexCoord[0].xy) * vec4(v, 1.0, 1.0 - v, v);
 }
@@ -19,20 +19,30 @@
 
 */
 
+// must match Game::MaxKeyholes
+#define MAX_CENTERS 8
+
 uniform sampler2D uTexture;
 uniform float uStretch;
 uniform float uAspect;
 uniform float uSharpness;
 uniform float uDarkest;
-uniform vec2 uCenter;
+uniform vec2 uCenter[MAX_CENTERS];
+uniform float uCenterCount;
 
 void main(void)
 {
   vec2 aspect = vec2(1.0 / uAspect, uAspect);
   vec2 coord = gl_TexCoord[0].st * aspect;
-  vec2 center = vec2(uCenter.x, 1.0 - uCenter.y) * aspect;
-  float dist = distance(center, coord) / uStretch;
-  float lightness = 1.0 - pow(dist, uSharpness);
+  // one keyhole per ball, combined as if they had been applied one after another
+  float lightness = 1.0;
+  for (int i = 0; i < MAX_CENTERS; ++i) {
+    if (float(i) < uCenterCount) {
+      vec2 center = vec2(uCenter[i].x, 1.0 - uCenter[i].y) * aspect;
+      float dist = distance(center, coord) / uStretch;
+      lightness *= clamp(1.0 - pow(dist, uSharpness), 0.0, 1.0);
+    }
+  }
   vec3 rgb = texture2D(uTexture, gl_TexCoord[0].st).rgb;
   gl_FragColor = vec4(rgb * lightness, 1.0);
 }
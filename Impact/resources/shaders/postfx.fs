@@ -0,0 +1,172 @@
+#version 110
+
+/*
+
+    Copyright (c) 2015 Oliver Lau <ola@ct.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+// All per-pixel post effects of the playground in one pass. The game
+// compiles a variant per combination of active effects by inserting
+// #defines for VIGNETTE, ABERRATION, EARTHQUAKE and MIX after the
+// first line. The distorting effects sample the stage before them at
+// their own texture coordinates, so the result equals running them
+// one after another. The source must have been display()ed, so that
+// SFML's texture matrix takes care of the render texture's orientation.
+
+uniform sampler2D uTexture;
+
+#ifdef VIGNETTE
+uniform float uVignetteStretch;
+uniform vec3 uHSV;
+
+vec3 rgb2hsv(vec3 c)
+{
+    vec4 K = vec4(0.0, -1.0 / 3.0, 2.0 / 3.0, -1.0);
+    vec4 p = mix(vec4(c.bg, K.wz), vec4(c.gb, K.xy), step(c.b, c.g));
+    vec4 q = mix(vec4(p.xyw, c.r), vec4(c.r, p.yzx), step(p.x, c.r));
+    float d = q.x - min(q.w, q.y);
+    float e = 1.0e-10;
+    return vec3(abs(q.z + (q.w - q.y) / (6.0 * d + e)), d / (q.x + e), q.x);
+}
+
+vec3 hsv2rgb(vec3 c)
+{
+    vec4 K = vec4(1.0, 2.0 / 3.0, 1.0 / 3.0, 3.0);
+    vec3 p = abs(fract(c.xxx + K.xyz) * 6.0 - K.www);
+    return c.z * mix(K.xxx, clamp(p - K.xxx, 0.0, 1.0), c.y);
+}
+#endif
+
+#ifdef ABERRATION
+uniform float uAberrationT;
+uniform float uAberrationMaxT;
+uniform float uAberrationDistort;
+uniform vec2 uAberrationCenter;
+
+vec2 barrelDistortion(vec2 coord, float amt) {
+  vec2 cc = coord - uAberrationCenter;
+  float dist = dot(cc, cc);
+  return coord + cc * dist * amt;
+}
+
+float sat(float t)
+{
+  return clamp(t, 0.0, 1.0);
+}
+
+float linterp(float t) {
+  return sat(1.0 - abs(2.0 * t - 1.0));
+}
+
+float remap(float t, float a, float b) {
+  return sat((t - a) / (b - a));
+}
+
+vec3 spectrum_offset(float t) {
+  float lo = step(t, 0.5);
+  float hi = 1.0 - lo;
+  float w = linterp(remap(t, 1.0 / 6.0, 5.0 / 6.0));
+  vec3 ret = vec3(lo, 1.0, hi) * vec3(1.0 - w, w, 1.0 - w);
+  return pow(ret, vec3(1.0 / 2.2));
+}
+
+float quadEaseInOut(float t, float b, float c, float d)
+{
+  t /= d/2.0;
+  if (t < 1.0) return c/2.0*t*t + b;
+  t--;
+  return -c/2.0 * (t*(t-2.0) - 1.0) + b;
+}
+#endif
+
+#ifdef EARTHQUAKE
+uniform vec2 uRShift;
+uniform vec2 uGShift;
+uniform vec2 uBShift;
+uniform float uEarthquakeT;
+uniform float uEarthquakeMaxT;
+
+float easeOutExpo(float t, float d) {
+  return pow(2.0, -10.0 * t / d);
+}
+#endif
+
+#ifdef MIX
+uniform vec4 uColorMix;
+uniform vec4 uColorAdd;
+uniform vec4 uColorSub;
+#endif
+
+
+vec3 source(vec2 coord)
+{
+  vec3 rgb = texture2D(uTexture, coord).rgb;
+#ifdef VIGNETTE
+  float dist = uVignetteStretch * distance(vec2(0.5, 0.5), coord);
+  float lightness = 1.0 - pow(dist, 1.65);
+  vec3 hsv = rgb2hsv(rgb);
+  hsv.x += uHSV.x;
+  hsv.yz *= uHSV.yz;
+  rgb = hsv2rgb(hsv) * lightness;
+#endif
+  return rgb;
+}
+
+
+vec3 aberration(vec2 coord)
+{
+#ifdef ABERRATION
+  float distort = uAberrationDistort * (1.0 - quadEaseInOut(uAberrationT, 0.0, 1.0, uAberrationMaxT));
+  vec3 sumcol = vec3(0.0);
+  vec3 sumw = vec3(0.0);
+  for (int i = 0; i < 10; ++i) {
+    float t = float(i) * 0.1;
+    vec3 w = spectrum_offset(t);
+    sumw += w;
+    sumcol += w * source(barrelDistortion(coord, distort * t));
+  }
+  return sumcol / sumw;
+#else
+  return source(coord);
+#endif
+}
+
+
+vec3 earthquake(vec2 coord)
+{
+#ifdef EARTHQUAKE
+  float intensity = easeOutExpo(uEarthquakeT / uEarthquakeMaxT, uEarthquakeMaxT - uEarthquakeT);
+  return vec3(
+    aberration(uRShift * intensity + coord).r,
+    aberration(uGShift * intensity + coord).g,
+    aberration(uBShift * intensity + coord).b
+  );
+#else
+  return aberration(coord);
+#endif
+}
+
+
+void main(void)
+{
+  vec2 pos = gl_TexCoord[0].xy;
+#ifdef MIX
+  gl_FragColor = uColorMix * (vec4(earthquake(pos), 1.0) + uColorAdd - uColorSub);
+#else
+  gl_FragColor = vec4(earthquake(pos), 1.0);
+#endif
+}
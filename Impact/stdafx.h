@@ -29,12 +29,6 @@
 #ifndef __STDAFX_H_
 #define __STDAFX_H_
 
-#pragma warning(push)
-#pragma warning(disable : 4996)
-#include <boost/signals2.hpp>
-#pragma warning(pop)
-
-
 #include <limits>
 #include <algorithm>
 #include <numeric>
@@ -44,15 +38,19 @@
 #include <map>
 #include <string>
 #include <fstream>
+#include <iterator>
 #include <iostream>
 #include <iomanip>
 #include <cstdint>
+#include <cstdlib>
+#include <cctype>
 #include <cassert>
 #include <sstream>
 #include <typeinfo>
 #include <thread>
 #include <future>
 #include <chrono>
+#include <ctime>
 #include <sys/stat.h>
 
 #include <GL/glew.h>
@@ -71,6 +69,8 @@
 #include "Easings.h"
 #include "Timer.h"
 #include "TileParam.h"
+#include "TextureAtlas.h"
+#include "SpriteBatch.h"
 #include "Level.h"
 #include "Destructible.h"
 #include "Body.h"
@@ -81,7 +81,13 @@
 #include "Racket.h"
 #include "Ground.h"
 #include "Wall.h"
-#include "Explosion.h"
+#include "ParticleSystem.h"
+#include "Trace.h"
+#include "Replay.h"
+#include "FrameProfiler.h"
+#include "Benchmark.h"
+#include "WorkerPool.h"
+#include "ShaderRegistry.h"
 #include "Impact.h"
 
 
@@ -49,6 +49,15 @@ namespace Impact {
   }
 
 
+  std::string timestamp(void)
+  {
+    char buf[32];
+    const std::time_t now = std::time(nullptr);
+    std::strftime(buf, sizeof(buf), "%Y%m%d-%H%M%S", std::localtime(&now));
+    return buf;
+  }
+
+
   bool base64_decode(std::string base64, uint8_t *&buf, unsigned long &sz) {
     std::string encodedString = rtrim(base64);
     std::size_t inLen = encodedString.size();
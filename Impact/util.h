@@ -245,6 +245,7 @@ namespace Impact {
 
   extern bool base64_decode(std::string, uint8_t *&, unsigned long &);
   extern bool fileExists(const std::string &);
+  extern std::string timestamp(void);
 
 }
 